@@ -0,0 +1,35 @@
+#pragma once
+
+#include "LOB/Types.h"
+#include "LOB/Order.h"
+#include "LOB/BookSnapshot.h"
+
+namespace LOB {
+
+// Compile-time observer of book changes, for BasicOrderBook<Listeners...>.
+// Derive and shadow the callbacks you need; calls are resolved statically, so
+// the defaults (and a book with no listeners at all) cost nothing.
+//
+// Order callbacks fire as the order changes: onOrderAdded once it rests in its
+// level, onOrderReduced after its size dropped (it is still resting),
+// onOrderRemoved after it left its level but before its slot is recycled.
+// Level callbacks fire when a price level enters or leaves the book.
+// onBestPriceChanged fires at most once per side per public book call, after
+// the call completed, with the new touch (INVALID_PRICE if the side emptied).
+// onTopOfBookChanged fires after that, at most once per call, when the best
+// price or the size at it moved on either side.
+//
+// Volume changes without a known order (snapshot seeding, fallback deletes of
+// pre-snapshot orders) are not order events; they only show up as level and
+// best price changes. reset() does not notify.
+struct BookListener {
+    void onOrderAdded(const Order&) {}
+    void onOrderReduced(const Order&, Quantity /*reducedBy*/) {}
+    void onOrderRemoved(const Order&) {}
+    void onLevelCreated(Side, Price) {}
+    void onLevelRemoved(Side, Price) {}
+    void onBestPriceChanged(Side, Price /*newBest*/) {}
+    void onTopOfBookChanged(const TopOfBook&) {}
+};
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "LOB/Types.h"
+
+namespace LOB {
+
+// A single aggregated price level (price, total resting volume)
+struct PriceLevel {
+    Price price;
+    Quantity volume;
+};
+
+// Best bid/ask and the volume resting at each
+struct TopOfBook {
+    Price bidPrice = INVALID_PRICE;
+    Quantity bidSize = 0;
+    Price askPrice = INVALID_PRICE;
+    Quantity askSize = 0;
+
+    bool operator==(const TopOfBook&) const = default;
+
+    // Same definitions as OrderBook::getOBI / getMicroprice
+    double obi() const {
+        if (bidPrice == INVALID_PRICE || askPrice == INVALID_PRICE) return 0.0;
+        if (bidSize + askSize == 0) return 0.0;
+        return static_cast<double>(static_cast<int64_t>(bidSize) - static_cast<int64_t>(askSize)) / static_cast<double>(bidSize + askSize);
+    }
+
+    double microprice() const {
+        if (bidPrice == INVALID_PRICE || askPrice == INVALID_PRICE) return 0.0;
+        if (bidSize + askSize == 0) return 0.0;
+        return (static_cast<double>(bidPrice * askSize) + static_cast<double>(askPrice * bidSize)) / static_cast<double>(bidSize + askSize);
+    }
+};
+
+// Bounded depth view of both sides, best level first
+template <size_t Depth = 10>
+struct DepthSnapshot {
+    static constexpr size_t kDepth = Depth;
+
+    uint32_t bidLevels = 0;
+    uint32_t askLevels = 0;
+    PriceLevel bids[Depth] = {};
+    PriceLevel asks[Depth] = {};
+};
+
+}
@@ -1,25 +1,23 @@
 #pragma once
 
-#include "LOB/MemoryMappedFile.h"
+#include "LOB/InputSource.h"
 #include "LOB/Types.h"
+#include "LOB/Message.h"
+#include <memory>
 #include <vector>
 #include <charconv>
 #include <iostream>
 
 namespace LOB {
 
-struct RAWMessage {
-    double timestamp;
-    int type;
-    uint64_t orderId;
-    uint64_t size;
-    int64_t price;
-    int direction;
-};
-
 class LobsterMessageParser {
 public:
-    LobsterMessageParser(const std::string& filePath) : file_(filePath), current_(file_.data()), end_(file_.data() + file_.size()) {}
+    // Plain files are memory-mapped; .gz / .zst are decompressed on a background thread (see openInput)
+    LobsterMessageParser(const std::string& filePath) : LobsterMessageParser(openInput(filePath)) {}
+
+    explicit LobsterMessageParser(std::unique_ptr<InputSource> source) : source_(std::move(source)) {
+        refill();
+    }
 
     bool hasNext() const {
         return current_ < end_;
@@ -62,13 +60,26 @@ public:
         msg.direction = std::strtol(current_, &nextToken, 10);
         current_ = nextToken; // Points to newline or end
 
+        // Chunks hold whole lines: once this one is used up, move to the next
+        while (current_ < end_ && (*current_ == '\n' || *current_ == '\r')) {
+            current_++;
+        }
+        if (current_ >= end_) refill();
+
         return true;
     }
 
 private:
-    MemoryMappedFile file_;
-    const char*current_;
-    const char* end_;
+    std::unique_ptr<InputSource> source_;
+    const char* current_ = nullptr;
+    const char* end_ = nullptr;
+
+    void refill() {
+        while (source_->nextChunk(current_, end_)) {
+            if (current_ < end_) return;
+        }
+        current_ = end_ = nullptr;
+    }
 };
 
 }
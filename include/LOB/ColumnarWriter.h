@@ -0,0 +1,264 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace LOB {
+
+enum class ColumnType : uint8_t {
+    Int32,
+    UInt32,
+    Int64,
+    UInt64,
+    Float64
+};
+
+inline size_t columnTypeSize(ColumnType type) {
+    return (type == ColumnType::Int32 || type == ColumnType::UInt32) ? 4 : 8;
+}
+
+// Column type that stores a T: 4/8-byte integers by signedness, double as Float64
+template <typename T>
+constexpr ColumnType columnTypeOf() {
+    static_assert((std::is_integral_v<T> && !std::is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8)) ||
+                      (std::is_floating_point_v<T> && sizeof(T) == 8),
+                  "columns hold 4- or 8-byte integers or doubles");
+    if constexpr (std::is_floating_point_v<T>) return ColumnType::Float64;
+    else if constexpr (sizeof(T) == 4) return std::is_signed_v<T> ? ColumnType::Int32 : ColumnType::UInt32;
+    else return std::is_signed_v<T> ? ColumnType::Int64 : ColumnType::UInt64;
+}
+
+// NumPy dtype string (little-endian host assumed, as on x86/ARM64)
+inline const char* columnTypeDescr(ColumnType type) {
+    switch (type) {
+        case ColumnType::Int32:   return "<i4";
+        case ColumnType::UInt32:  return "<u4";
+        case ColumnType::Int64:   return "<i8";
+        case ColumnType::UInt64:  return "<u8";
+        case ColumnType::Float64: return "<f8";
+    }
+    return "<u1";
+}
+
+struct ColumnSpec {
+    std::string name;
+    ColumnType type;
+};
+
+// Writes a fixed-size .npy (format 1.0) header for a 1-D array.
+// The header is always padded to kNpyHeaderSize so it can be rewritten in place
+// once the final row count is known.
+constexpr size_t kNpyHeaderSize = 128;
+
+inline void writeNpyHeader(std::FILE* file, ColumnType type, uint64_t rows) {
+    char header[kNpyHeaderSize];
+    std::memset(header, ' ', sizeof(header));
+    std::memcpy(header, "\x93NUMPY\x01\x00", 8);
+    const uint16_t dictLen = static_cast<uint16_t>(kNpyHeaderSize - 10);
+    header[8] = static_cast<char>(dictLen & 0xFF);
+    header[9] = static_cast<char>(dictLen >> 8);
+    int n = std::snprintf(header + 10, kNpyHeaderSize - 10, "{'descr': '%s', 'fortran_order': False, 'shape': (%llu,), }",
+                          columnTypeDescr(type), static_cast<unsigned long long>(rows));
+    header[10 + n] = ' '; // overwrite snprintf's terminator
+    header[kNpyHeaderSize - 1] = '\n';
+    std::fwrite(header, 1, sizeof(header), file);
+}
+
+// Columnar, memory-mappable output.
+//
+// Every selected column becomes `<directory>/<name>.npy`: one contiguous array
+// behind NumPy's self-describing header, so Python can do
+//     np.load("out/bid_px_0.npy", mmap_mode="r")
+// without any parsing.
+//
+// The producing (book) thread fills rows into a chunk that stores each column
+// contiguously; full chunks are handed to a background thread that appends
+// them to the column files. Chunks are recycled from a small fixed pool, so the
+// steady state does no allocation and the book thread only blocks if the disk
+// falls a full pool behind.
+class ColumnarWriter {
+public:
+    ColumnarWriter(const std::string& directory, std::vector<ColumnSpec> columns,
+                   size_t chunkRows = 4096, size_t poolChunks = 16)
+        : columns_(std::move(columns)), chunkRows_(chunkRows) {
+        std::filesystem::create_directories(directory);
+
+        size_t offset = 0;
+        for (const auto& col : columns_) {
+            offsets_.push_back(offset);
+            // Keep every column 64-byte aligned inside the chunk
+            offset += (columnTypeSize(col.type) * chunkRows_ + 63) & ~size_t(63);
+        }
+        chunkBytes_ = offset;
+
+        for (const auto& col : columns_) {
+            std::string path = (std::filesystem::path(directory) / (col.name + ".npy")).string();
+            std::FILE* file = std::fopen(path.c_str(), "wb");
+            if (!file) {
+                closeFiles();
+                throw std::runtime_error("Failed to open output file: " + path);
+            }
+            writeNpyHeader(file, col.type, 0);
+            files_.push_back(file);
+        }
+
+        for (size_t i = 0; i < poolChunks; ++i) {
+            pool_.push_back(std::make_unique<Chunk>(chunkBytes_));
+            free_.push_back(pool_.back().get());
+        }
+        current_ = takeFreeChunk();
+
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~ColumnarWriter() {
+        try {
+            close();
+        } catch (...) {
+        }
+    }
+
+    ColumnarWriter(const ColumnarWriter&) = delete;
+    ColumnarWriter& operator=(const ColumnarWriter&) = delete;
+
+    size_t columnCount() const { return columns_.size(); }
+    const ColumnSpec& column(size_t i) const { return columns_[i]; }
+
+    // Set a value of the current row. columnTypeOf<T>() must be the column's
+    // ColumnType (spell T out, e.g. set<int64_t>(c, 0): a bare literal deduces
+    // int); a mismatch throws rather than writing the wrong bytes.
+    template <typename T>
+    void set(size_t column, T value) {
+        if (column >= columns_.size()) throw std::out_of_range("ColumnarWriter: no column " + std::to_string(column));
+        if (columns_[column].type != columnTypeOf<T>()) {
+            throw std::invalid_argument("ColumnarWriter: wrong value type for column " + columns_[column].name);
+        }
+        reinterpret_cast<T*>(current_->data.get() + offsets_[column])[current_->rows] = value;
+    }
+
+    void commitRow() {
+        if (++current_->rows == chunkRows_) {
+            submit(current_);
+            current_ = takeFreeChunk();
+        }
+        ++totalRows_;
+    }
+
+    uint64_t rows() const { return totalRows_; }
+
+    // Flush pending chunks, finalize headers with the row count and close the files.
+    // Throws if any write failed.
+    void close() {
+        if (closed_) return;
+        closed_ = true;
+
+        if (current_->rows > 0) submit(current_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        workCv_.notify_one();
+        worker_.join();
+
+        for (size_t i = 0; i < files_.size(); ++i) {
+            std::fseek(files_[i], 0, SEEK_SET);
+            writeNpyHeader(files_[i], columns_[i].type, totalRows_);
+            if (std::ferror(files_[i])) failed_ = true;
+        }
+        closeFiles();
+
+        if (failed_) throw std::runtime_error("ColumnarWriter: write failed");
+    }
+
+private:
+    struct Chunk {
+        explicit Chunk(size_t bytes) : data(new (std::align_val_t(64)) char[bytes]) {}
+        struct AlignedDelete {
+            void operator()(char* p) const { ::operator delete[](p, std::align_val_t(64)); }
+        };
+        std::unique_ptr<char[], AlignedDelete> data;
+        size_t rows = 0;
+    };
+
+    std::vector<ColumnSpec> columns_;
+    std::vector<size_t> offsets_;
+    std::vector<std::FILE*> files_;
+    size_t chunkRows_;
+    size_t chunkBytes_ = 0;
+
+    std::vector<std::unique_ptr<Chunk>> pool_;
+    Chunk* current_ = nullptr;
+    uint64_t totalRows_ = 0;
+    bool closed_ = false;
+
+    // Shared with the writer thread
+    std::mutex mutex_;
+    std::condition_variable workCv_;
+    std::condition_variable freeCv_;
+    std::deque<Chunk*> full_;
+    std::vector<Chunk*> free_;
+    bool stop_ = false;
+    bool failed_ = false;
+    std::thread worker_;
+
+    Chunk* takeFreeChunk() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        freeCv_.wait(lock, [this] { return !free_.empty(); });
+        Chunk* chunk = free_.back();
+        free_.pop_back();
+        chunk->rows = 0;
+        return chunk;
+    }
+
+    void submit(Chunk* chunk) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            full_.push_back(chunk);
+        }
+        workCv_.notify_one();
+    }
+
+    void run() {
+        for (;;) {
+            Chunk* chunk;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                workCv_.wait(lock, [this] { return stop_ || !full_.empty(); });
+                if (full_.empty()) return; // stop_ and drained
+                chunk = full_.front();
+                full_.pop_front();
+            }
+
+            bool ok = true;
+            for (size_t i = 0; i < files_.size(); ++i) {
+                size_t elem = columnTypeSize(columns_[i].type);
+                ok &= std::fwrite(chunk->data.get() + offsets_[i], elem, chunk->rows, files_[i]) == chunk->rows;
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!ok) failed_ = true;
+                free_.push_back(chunk);
+            }
+            freeCv_.notify_one();
+        }
+    }
+
+    void closeFiles() {
+        for (std::FILE* file : files_) std::fclose(file);
+        files_.clear();
+    }
+};
+
+}
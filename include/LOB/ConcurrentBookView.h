@@ -0,0 +1,64 @@
+#pragma once
+
+#include "LOB/OrderBook.h"
+#include "LOB/BookSnapshot.h"
+#include "LOB/SeqLock.h"
+
+namespace LOB {
+
+// Lock-free read access to a book owned by another thread.
+//
+// The thread that mutates the book (the single writer; any BasicOrderBook)
+// calls publish() after applying a message. Any number of reader threads can then call the
+// getters below concurrently: each returns a consistent copy taken from a
+// seqlock, so readers never block the writer and never touch bids_/asks_.
+//
+// Top-of-book and depth are published separately: strategy threads that only
+// need the touch read a single cache-line-sized payload.
+template <size_t Depth = 10>
+class ConcurrentBookView {
+public:
+    using Snapshot = DepthSnapshot<Depth>;
+
+    // --- Writer side (book thread only) ---
+
+    // Publish top-of-book and a Depth-level snapshot of each side
+    template <typename... Listeners>
+    void publish(const BasicOrderBook<Listeners...>& book) {
+        publishTop(book);
+        publishDepth(book);
+    }
+
+    // Publish only top-of-book (cheap: two map begin() lookups)
+    template <typename... Listeners>
+    void publishTop(const BasicOrderBook<Listeners...>& book) {
+        top_.store(book.getTopOfBook());
+    }
+
+    template <typename... Listeners>
+    void publishDepth(const BasicOrderBook<Listeners...>& book) {
+        Snapshot snapshot;
+        snapshot.bidLevels = static_cast<uint32_t>(book.getDepth(Side::Buy, snapshot.bids, Depth));
+        snapshot.askLevels = static_cast<uint32_t>(book.getDepth(Side::Sell, snapshot.asks, Depth));
+        depth_.store(snapshot);
+    }
+
+    // --- Reader side (any thread) ---
+
+    TopOfBook getTopOfBook() const { return top_.load(); }
+    Snapshot getDepth() const { return depth_.load(); }
+
+    Price getBestBid() const { return top_.load().bidPrice; }
+    Price getBestAsk() const { return top_.load().askPrice; }
+    double getOBI() const { return top_.load().obi(); }
+    double getMicroprice() const { return top_.load().microprice(); }
+
+    // Number of top-of-book publications so far (readers can use it to detect updates)
+    uint64_t version() const { return top_.version(); }
+
+private:
+    SeqLock<TopOfBook> top_;
+    SeqLock<Snapshot> depth_;
+};
+
+}
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include "LOB/BookSnapshot.h"
+#include "LOB/OrderBook.h"
+
+namespace LOB {
+
+// Best bid/ask across venues: price, the size summed over every venue at that
+// price, and which venues are there (bit v = venue v).
+struct ConsolidatedQuote {
+    Price bidPrice = INVALID_PRICE;
+    Quantity bidSize = 0;
+    uint64_t bidVenues = 0;
+    Price askPrice = INVALID_PRICE;
+    Quantity askSize = 0;
+    uint64_t askVenues = 0;
+
+    bool operator==(const ConsolidatedQuote&) const = default;
+
+    bool crossed() const {
+        return bidPrice != INVALID_PRICE && askPrice != INVALID_PRICE && bidPrice > askPrice;
+    }
+};
+
+// Consolidated top of book over up to MaxVenues per-venue OrderBooks of one instrument.
+//
+// Each venue's touch sits in a leaf of a fixed-size tournament tree per side;
+// every internal node holds the better of its two children, merging them when
+// they quote the same price (sizes add, venue masks OR). A venue update
+// rewrites one leaf and replays at most log2(venues) matches above it,
+// stopping as soon as a match result is unchanged, so the consolidated quote at
+// the root costs O(log venues) to maintain instead of rescanning every book.
+// A side whose venue touch did not change is skipped entirely.
+//
+// Either call update() (or onBookChanged(venue, book)) after each message
+// applied to a venue's book, or build the venue books with a VenueListener,
+// which pushes the venue's touch only when its best price or size moved.
+// There is no internal locking: every call, for every venue,
+// must come from one thread (or be serialized by the caller). The listener
+// fires, and update() returns true, only when the consolidated quote itself
+// changed.
+template <size_t MaxVenues = 16>
+class ConsolidatedBook {
+    static_assert(MaxVenues >= 1 && MaxVenues <= 64, "venue set is a 64-bit mask");
+
+public:
+    using Listener = std::function<void(const ConsolidatedQuote&)>;
+
+    // Book listener feeding one venue, e.g.
+    //   BasicOrderBook<ConsolidatedBook<16>::VenueListener> book(n, {nbbo, v});
+    // The ConsolidatedBook must outlive the book.
+    struct VenueListener : BookListener {
+        ConsolidatedBook* consolidated;
+        size_t venue;
+
+        VenueListener(ConsolidatedBook& book, size_t v) : consolidated(&book), venue(v) { book.checkVenue(v); }
+
+        void onTopOfBookChanged(const TopOfBook& top) { consolidated->update(venue, top); }
+    };
+
+    explicit ConsolidatedBook(size_t venueCount = MaxVenues)
+        : venueCount_(venueCount), bids_(venueCount), asks_(venueCount) {
+        if (venueCount == 0 || venueCount > MaxVenues) {
+            throw std::invalid_argument("ConsolidatedBook: venue count out of range");
+        }
+    }
+
+    size_t venueCount() const { return venueCount_; }
+
+    // Called with the new quote whenever the consolidated quote changes
+    void setListener(Listener listener) { listener_ = std::move(listener); }
+
+    const ConsolidatedQuote& quote() const { return quote_; }
+
+    // Last touch reported by one venue
+    const TopOfBook& venue(size_t v) const {
+        checkVenue(v);
+        return venues_[v];
+    }
+
+    // Number of consolidated-quote changes emitted so far
+    uint64_t changes() const { return changes_; }
+
+    template <typename... Listeners>
+    bool onBookChanged(size_t v, const BasicOrderBook<Listeners...>& book) {
+        return update(v, book.getTopOfBook());
+    }
+
+    // Record venue v's touch. Returns true if the consolidated quote changed.
+    // Throws std::out_of_range unless v < venueCount().
+    bool update(size_t v, const TopOfBook& top) {
+        checkVenue(v);
+        TopOfBook& previous = venues_[v];
+        bool touched = false;
+        if (top.bidPrice != previous.bidPrice || top.bidSize != previous.bidSize) {
+            bids_.set(v, leafOf(top.bidPrice, top.bidSize, v));
+            touched = true;
+        }
+        if (top.askPrice != previous.askPrice || top.askSize != previous.askSize) {
+            asks_.set(v, leafOf(askKey(top.askPrice), top.askSize, v));
+            touched = true;
+        }
+        previous = top;
+        if (!touched) return false;
+
+        const Entry& bid = bids_.root();
+        const Entry& ask = asks_.root();
+        ConsolidatedQuote next{bid.key, bid.size, bid.venues, askKey(ask.key), ask.size, ask.venues};
+        if (next == quote_) return false;
+        quote_ = next;
+        changes_++;
+        if (listener_) listener_(quote_);
+        return true;
+    }
+
+private:
+    void checkVenue(size_t v) const {
+        if (v >= venueCount_) throw std::out_of_range("ConsolidatedBook: venue index out of range");
+    }
+
+    // Both trees are "higher key wins": bids use the price, asks its negation.
+    // An empty side is INVALID_PRICE (the minimum), so it loses every match
+    // without a special case.
+    struct Entry {
+        Price key = INVALID_PRICE;
+        Quantity size = 0;
+        uint64_t venues = 0;
+
+        bool operator==(const Entry&) const = default;
+    };
+
+    // Self-inverse, keeps INVALID_PRICE
+    static Price askKey(Price p) { return p == INVALID_PRICE ? INVALID_PRICE : -p; }
+
+    static Entry leafOf(Price key, Quantity size, size_t v) {
+        if (key == INVALID_PRICE) return Entry{};
+        return Entry{key, size, uint64_t(1) << v};
+    }
+
+    // Winner tree over a power-of-two number of leaves (the venue count rounded
+    // up); node 1 is the root, leaves start at leaves_. Unused leaves stay empty.
+    class Tournament {
+    public:
+        explicit Tournament(size_t venues) : leaves_(std::bit_ceil(venues < 2 ? size_t(2) : venues)) {}
+
+        void set(size_t v, const Entry& leaf) {
+            size_t node = leaves_ + v;
+            nodes_[node] = leaf;
+            for (node >>= 1; node > 0; node >>= 1) {
+                Entry winner = play(nodes_[2 * node], nodes_[2 * node + 1]);
+                // Same result as before: nothing above can change either
+                if (winner == nodes_[node]) break;
+                nodes_[node] = winner;
+            }
+        }
+
+        const Entry& root() const { return nodes_[1]; }
+
+    private:
+        static constexpr size_t kMaxLeaves = std::bit_ceil(MaxVenues < 2 ? size_t(2) : MaxVenues);
+        size_t leaves_;
+        std::array<Entry, 2 * kMaxLeaves> nodes_{};
+
+        // Branch-free: quote updates make the winner unpredictable
+        static Entry play(const Entry& a, const Entry& b) {
+            Entry winner;
+            winner.key = std::max(a.key, b.key);
+            const bool takeA = a.key == winner.key;
+            const bool takeB = b.key == winner.key;
+            winner.size = (takeA ? a.size : 0) + (takeB ? b.size : 0);
+            winner.venues = (takeA ? a.venues : 0) | (takeB ? b.venues : 0);
+            return winner;
+        }
+    };
+
+    size_t venueCount_;
+    std::array<TopOfBook, MaxVenues> venues_{};
+    Tournament bids_;
+    Tournament asks_;
+    ConsolidatedQuote quote_;
+    uint64_t changes_ = 0;
+    Listener listener_;
+};
+
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "LOB/Types.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace LOB {
+
+// Result of walking one side of the book for a given size
+struct SweepEstimate {
+    Quantity filled = 0;     // min(requested, available)
+    int64_t notional = 0;    // sum(price * qty) over the filled quantity
+    Price lastPrice = INVALID_PRICE; // worst price touched
+    size_t levels = 0;       // levels touched (including a partially consumed one)
+
+    double vwap() const {
+        return filled == 0 ? 0.0 : static_cast<double>(notional) / static_cast<double>(filled);
+    }
+};
+
+// Contiguous (price, volume) array for one side of the book.
+//
+// The std::map in OrderBook is the source of truth for ordering and Limit
+// ownership; the ladder mirrors it as structure-of-arrays so depth queries
+// scan plain memory instead of chasing tree nodes and Limit pointers.
+//
+// Levels are stored worst -> best, i.e. the touch is at the back. Most
+// activity happens near the touch, so inserts/erases there move few elements.
+// A third column caches price * volume so sweeps can sum notional without
+// 64-bit multiplies in the scan loop.
+class DepthLadder {
+public:
+    explicit DepthLadder(Side side, size_t reserveLevels = 1024) : side_(side) {
+        prices_.reserve(reserveLevels);
+        volumes_.reserve(reserveLevels);
+        notionals_.reserve(reserveLevels);
+    }
+
+    size_t size() const { return prices_.size(); }
+    bool empty() const { return prices_.empty(); }
+
+    size_t memoryUsage() const {
+        return prices_.capacity() * sizeof(Price) + volumes_.capacity() * sizeof(Quantity) + notionals_.capacity() * sizeof(int64_t);
+    }
+    void clear() {
+        prices_.clear();
+        volumes_.clear();
+        notionals_.clear();
+    }
+
+    // Level i counted from the touch (0 = best)
+    Price priceAt(size_t level) const { return prices_[prices_.size() - 1 - level]; }
+    Quantity volumeAt(size_t level) const { return volumes_[volumes_.size() - 1 - level]; }
+
+    // Insert the level if missing, then set its volume
+    void setVolume(Price price, Quantity volume) {
+        size_t i = lowerBound(price);
+        if (i == prices_.size() || prices_[i] != price) {
+            prices_.insert(prices_.begin() + i, price);
+            volumes_.insert(volumes_.begin() + i, volume);
+            notionals_.insert(notionals_.begin() + i, price * static_cast<int64_t>(volume));
+            return;
+        }
+        volumes_[i] = volume;
+        notionals_[i] = price * static_cast<int64_t>(volume);
+    }
+
+    void erase(Price price) {
+        size_t i = lowerBound(price);
+        if (i == prices_.size() || prices_[i] != price) return;
+        prices_.erase(prices_.begin() + i);
+        volumes_.erase(volumes_.begin() + i);
+        notionals_.erase(notionals_.begin() + i);
+    }
+
+    // Number of levels, counted from the touch, priced at or better than limitPrice
+    size_t levelsWithin(Price limitPrice) const {
+        // Levels better than limitPrice sort after it
+        size_t i = side_ == Side::Buy
+            ? std::lower_bound(prices_.begin(), prices_.end(), limitPrice) - prices_.begin()
+            : std::lower_bound(prices_.begin(), prices_.end(), limitPrice, std::greater<Price>()) - prices_.begin();
+        return prices_.size() - i;
+    }
+
+    // Total volume of the best `levels` levels
+    Quantity sumVolume(size_t levels) const {
+        levels = std::min(levels, volumes_.size());
+        return sumRange(volumes_.data() + volumes_.size() - levels, levels);
+    }
+
+    // Walk from the touch until `quantity` is reached.
+    // Returns the number of fully consumed levels; `consumed`/`notional` cover those levels only.
+    size_t scanFullLevels(Quantity quantity, Quantity& consumed, int64_t& notional) const {
+        const size_t n = volumes_.size();
+        const Quantity* vol = volumes_.data();
+        size_t full = 0;
+        Quantity running = 0;
+
+#if defined(__AVX2__)
+        // 4 levels per step: in-register inclusive prefix sum of the (reversed) block,
+        // then compare against the target to find the first level that completes the fill.
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i target = _mm256_set1_epi64x(static_cast<int64_t>(quantity));
+        // Running total stays broadcast in a register: the loop-carried chain is one add + one permute
+        __m256i carry = zero;
+        while (full + 4 <= n) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(vol + n - full - 4));
+            v = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 1, 2, 3)); // lane 0 = closest to touch
+            v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+            v = _mm256_add_epi64(v, _mm256_blend_epi32(_mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+            v = _mm256_add_epi64(v, carry);
+
+            // prefix >= target  <=>  !(target > prefix)
+            int reached = ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(target, v))) & 0xF;
+            if (reached) {
+                size_t lane = static_cast<size_t>(std::countr_zero(static_cast<unsigned>(reached)));
+                alignas(32) int64_t prefix[4];
+                _mm256_store_si256(reinterpret_cast<__m256i*>(prefix), v);
+                running = lane > 0 ? static_cast<Quantity>(prefix[lane - 1]) : static_cast<Quantity>(_mm256_extract_epi64(carry, 0));
+                full += lane;
+                carry = zero;
+                break;
+            }
+            carry = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3));
+            full += 4;
+        }
+        running += static_cast<Quantity>(_mm256_extract_epi64(carry, 0));
+#endif
+        // Scalar tail (no-op if the vector loop already found the level)
+        while (full < n && running + vol[n - 1 - full] < quantity) {
+            running += vol[n - 1 - full];
+            ++full;
+        }
+
+        consumed = running;
+        notional = sumRange(notionals_.data() + n - full, full);
+        return full;
+    }
+
+private:
+    Side side_;
+    std::vector<Price> prices_;
+    std::vector<Quantity> volumes_;
+    std::vector<int64_t> notionals_;
+
+    // First index whose price is not worse than `price` (ascending = worst -> best)
+    size_t lowerBound(Price price) const {
+        if (side_ == Side::Buy) {
+            return std::lower_bound(prices_.begin(), prices_.end(), price) - prices_.begin();
+        }
+        return std::lower_bound(prices_.begin(), prices_.end(), price, std::greater<Price>()) - prices_.begin();
+    }
+
+    template <typename T>
+    static T sumRange(const T* data, size_t count) {
+        size_t i = 0;
+        T total = 0;
+#if defined(__AVX2__)
+        __m256i acc = _mm256_setzero_si256();
+        for (; i + 4 <= count; i += 4) {
+            acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+        }
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        total = static_cast<T>(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+#endif
+        for (; i < count; ++i) total += data[i];
+        return total;
+    }
+};
+
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LOB/CSVParser.h"
+#include "LOB/OrderBook.h"
+#include "LOB/Replay.h"
+
+namespace LOB {
+
+// One replayed event: the parsed message and the book's touch right after it.
+// Plain fixed-layout struct so a chunk of them is directly a NumPy record array.
+struct EventRecord {
+    double timestamp;
+    int32_t type;
+    int32_t direction;
+    uint64_t orderId;
+    uint64_t size;
+    int64_t price;
+    Price bidPrice; // INVALID_PRICE when the side is empty
+    Quantity bidSize;
+    Price askPrice;
+    Quantity askSize;
+};
+
+// A run of consecutive events. Records stay valid for as long as the chunk is held.
+struct EventChunk {
+    std::vector<EventRecord> records;
+};
+
+// Replays a LOBSTER message file on a background thread and hands the events
+// out in fixed-size chunks, so decoding and applying chunk N+1 overlaps with
+// the consumer working on chunk N.
+//
+// With an orderbook file the replay is verified exactly like lob_sim
+// (replayVerified: seeded from the first truth row, message 1 skipped, touch
+// healed against the truth); without one every message is applied to an empty
+// book as is.
+//
+// At most `prefetch` finished chunks wait in the queue; the producer blocks
+// beyond that. Chunks are handed out as shared_ptrs and return to a free list
+// when the consumer drops them, so steady-state streaming does not allocate
+// and a consumer that keeps chunks (e.g. to concatenate them) simply causes
+// new ones to be allocated. Destroying the stream stops the producer early.
+class EventStream {
+public:
+    explicit EventStream(std::string messagePath, std::string orderbookPath = "", size_t chunkSize = 65536,
+                         size_t prefetch = 2, size_t expectedOrders = 1000000)
+        : messagePath_(std::move(messagePath)), orderbookPath_(std::move(orderbookPath)),
+          chunkSize_(chunkSize == 0 ? 1 : chunkSize), prefetch_(prefetch == 0 ? 1 : prefetch),
+          state_(std::make_shared<State>()), book_(expectedOrders) {
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~EventStream() {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stop = true;
+        }
+        state_->spaceCv.notify_all();
+        worker_.join();
+    }
+
+    EventStream(const EventStream&) = delete;
+    EventStream& operator=(const EventStream&) = delete;
+
+    // Next chunk, blocking until it is ready; nullptr once the file is exhausted.
+    // Rethrows a failure of the producer (e.g. a missing file).
+    std::shared_ptr<const EventChunk> next() {
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        state_->readyCv.wait(lock, [this] { return !state_->ready.empty() || state_->finished; });
+        if (state_->ready.empty()) {
+            if (state_->error) std::rethrow_exception(state_->error);
+            return nullptr;
+        }
+        std::unique_ptr<EventChunk> chunk = std::move(state_->ready.front());
+        state_->ready.pop_front();
+        lock.unlock();
+        state_->spaceCv.notify_one();
+
+        // Back to the free list when the consumer lets go (the state outlives the stream if needed)
+        std::shared_ptr<State> state = state_;
+        return std::shared_ptr<const EventChunk>(chunk.release(), [state](const EventChunk* done) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->free.emplace_back(const_cast<EventChunk*>(done));
+        });
+    }
+
+    // A copy of the producer's totals. Throws std::logic_error until the
+    // producer is done with the file, which it is by the time next() returns nullptr.
+    ReplayStats stats() const {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (!state_->finished) throw std::logic_error("EventStream: stats are available once the replay has finished");
+        return state_->stats;
+    }
+
+    size_t chunkSize() const { return chunkSize_; }
+
+private:
+    struct State {
+        std::mutex mutex;
+        std::condition_variable readyCv;
+        std::condition_variable spaceCv;
+        std::deque<std::unique_ptr<EventChunk>> ready;
+        std::vector<std::unique_ptr<EventChunk>> free;
+        bool stop = false;
+        bool finished = false;
+        std::exception_ptr error;
+        ReplayStats stats; // set with `finished`
+    };
+
+    // Thrown out of the replay loop when the stream is destroyed mid-file
+    struct Stopped {};
+
+    std::string messagePath_;
+    std::string orderbookPath_;
+    size_t chunkSize_;
+    size_t prefetch_;
+    std::shared_ptr<State> state_;
+    OrderBook book_;
+    std::unique_ptr<EventChunk> current_;
+    std::thread worker_;
+
+    struct Hooks : ReplayHooks {
+        EventStream* stream;
+        void afterMessage(const RAWMessage& msg, const OrderBook& book, uint64_t) { stream->record(msg, book); }
+    };
+
+    void record(const RAWMessage& msg, const OrderBook& book) {
+        const TopOfBook top = book.getTopOfBook();
+        current_->records.push_back(EventRecord{msg.timestamp, msg.type, msg.direction, msg.orderId, msg.size, msg.price,
+                                                top.bidPrice, top.bidSize, top.askPrice, top.askSize});
+        if (current_->records.size() == chunkSize_) publish();
+    }
+
+    void takeChunk() {
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            if (!state_->free.empty()) {
+                current_ = std::move(state_->free.back());
+                state_->free.pop_back();
+            }
+        }
+        if (!current_) {
+            current_ = std::make_unique<EventChunk>();
+            current_->records.reserve(chunkSize_);
+        }
+        current_->records.clear();
+    }
+
+    void publish() {
+        {
+            std::unique_lock<std::mutex> lock(state_->mutex);
+            state_->spaceCv.wait(lock, [this] { return state_->ready.size() < prefetch_ || state_->stop; });
+            if (state_->stop) throw Stopped{};
+            state_->ready.push_back(std::move(current_));
+        }
+        state_->readyCv.notify_one();
+        takeChunk();
+    }
+
+    void run() {
+        ReplayStats stats;
+        try {
+            takeChunk();
+            if (!orderbookPath_.empty()) {
+                Hooks hooks;
+                hooks.stream = this;
+                stats = replayVerified(book_, messagePath_, orderbookPath_, hooks);
+            } else {
+                auto timeStart = std::chrono::steady_clock::now();
+                LobsterMessageParser parser(messagePath_);
+                RAWMessage msg;
+                while (parser.next(msg)) {
+                    book_.apply(msg);
+                    stats.messages++;
+                    record(msg, book_);
+                }
+                stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+            }
+            if (!current_->records.empty()) publish();
+        } catch (const Stopped&) {
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->error = std::current_exception();
+        }
+        {
+            std::lock_guard<std::mutex> lock(state_->mutex);
+            state_->stats = stats;
+            state_->finished = true;
+        }
+        state_->readyCv.notify_all();
+    }
+};
+
+}
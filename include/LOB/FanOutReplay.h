@@ -0,0 +1,282 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LOB/CSVParser.h"
+#include "LOB/OrderBook.h"
+#include "LOB/Replay.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace LOB {
+
+// One replayed event as published to fan-out workers: the message and the
+// reference book's state right after it.
+struct FanOutEvent {
+    uint64_t sequence;     // 0, 1, 2, ... in publication order
+    RAWMessage msg;
+    Quantity levelVolume;  // volume now resting at msg.price on msg's side (0 = level gone)
+    TopOfBook top;         // touch after the event (after healing, in verified replay)
+};
+
+enum class FanOutMode {
+    FreeRunning, // each worker runs as far ahead as the ring allows
+    Lockstep     // no worker runs more than `lockstepWindow` events ahead of the slowest
+};
+
+struct FanOutConfig {
+    size_t ringCapacity = 1 << 16;  // events; rounded up to a power of two
+    FanOutMode mode = FanOutMode::FreeRunning;
+    size_t lockstepWindow = 1024;
+    size_t maxBatch = 256;          // events handed to a worker per call
+    size_t publishBatch = 64;       // producer makes events visible this many at a time
+    size_t expectedOrders = 1000000;
+};
+
+struct FanOutStats {
+    ReplayStats replay;
+    uint64_t events = 0;
+    uint64_t producerStalls = 0;          // waits for the slowest worker (ring full)
+    std::vector<uint64_t> consumed;       // events seen, per worker
+    std::vector<uint64_t> workerStalls;   // waits for the producer or, in lockstep, the slowest worker
+    double seconds = 0.0;
+};
+
+// Single-producer, multi-consumer broadcast ring: every consumer reads every
+// event, in order, straight out of the shared slots (read-only spans, no copy).
+//
+// Each consumer owns a cache-line-padded cursor. The producer may only reuse a
+// slot once every cursor has passed it, so the slowest consumer applies
+// backpressure; the producer rescans the cursors only when its cached minimum
+// says the ring is full. Consumers see the producer's progress through one
+// `published` counter, updated every publishBatch events.
+//
+// Waiting spins briefly, then yields, so an oversubscribed machine still
+// makes progress.
+class FanOutRing {
+public:
+    FanOutRing(size_t capacity, size_t consumers, const FanOutConfig& config)
+        : capacity_(std::bit_ceil(std::max<size_t>(capacity, 2))), mask_(capacity_ - 1),
+          slots_(capacity_), cursors_(consumers), lockstep_(config.mode == FanOutMode::Lockstep),
+          window_(std::max<size_t>(config.lockstepWindow, 1)), maxBatch_(std::max<size_t>(config.maxBatch, 1)),
+          publishBatch_(std::clamp<size_t>(config.publishBatch, 1, capacity_ / 2)) {}
+
+    size_t capacity() const { return capacity_; }
+
+    // --- Producer ---
+
+    // Slot for the next event; blocks while the slowest consumer is a full ring behind
+    FanOutEvent& claim() {
+        if (head_ - cachedMin_ >= capacity_) {
+            publish();
+            cachedMin_ = minCursor();
+            while (head_ - cachedMin_ >= capacity_) {
+                producerStalls_++;
+                backoff();
+                cachedMin_ = minCursor();
+            }
+        }
+        FanOutEvent& slot = slots_[head_ & mask_];
+        slot.sequence = head_;
+        return slot;
+    }
+
+    void commit() {
+        if (++head_ - lastPublished_ >= publishBatch_) publish();
+    }
+
+    // No more events; consumers drain what is there and stop
+    void close() {
+        publish();
+        closed_.store(true, std::memory_order_release);
+    }
+
+    uint64_t published() const { return head_; }
+    uint64_t producerStalls() const { return producerStalls_; }
+
+    // --- Consumer c ---
+
+    // Next run of unread events (contiguous in the ring), waiting if there are
+    // none yet; empty once the ring is closed and drained. Hand the span back
+    // with release() before asking again.
+    std::span<const FanOutEvent> acquire(size_t c) {
+        Cursor& self = cursors_[c];
+        const uint64_t cursor = self.position.load(std::memory_order_relaxed);
+        for (int spins = 0;; ++spins) {
+            const bool closed = closed_.load(std::memory_order_acquire);
+            uint64_t limit = published_.load(std::memory_order_acquire);
+            if (lockstep_) limit = std::min<uint64_t>(limit, minCursor() + window_);
+            if (limit > cursor) {
+                const uint64_t n = std::min<uint64_t>({limit - cursor, maxBatch_, capacity_ - (cursor & mask_)});
+                return {&slots_[cursor & mask_], static_cast<size_t>(n)};
+            }
+            if (closed && cursor >= published_.load(std::memory_order_acquire)) return {};
+            if (spins == 0) self.stalls++;
+            backoff();
+        }
+    }
+
+    void release(size_t c, size_t count) {
+        Cursor& self = cursors_[c];
+        self.position.store(self.position.load(std::memory_order_relaxed) + count, std::memory_order_release);
+        self.consumed += count;
+    }
+
+    // Stop counting consumer c (e.g. it failed), so it no longer holds anyone back
+    void detach(size_t c) { cursors_[c].position.store(kDetached, std::memory_order_release); }
+
+    uint64_t consumed(size_t c) const { return cursors_[c].consumed; }
+    uint64_t stalls(size_t c) const { return cursors_[c].stalls; }
+
+private:
+    static constexpr uint64_t kDetached = std::numeric_limits<uint64_t>::max() / 2;
+
+    struct alignas(64) Cursor {
+        std::atomic<uint64_t> position{0};
+        uint64_t consumed = 0; // owner thread only
+        uint64_t stalls = 0;
+    };
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::vector<FanOutEvent> slots_;
+    std::vector<Cursor> cursors_;
+    const bool lockstep_;
+    const size_t window_;
+    const size_t maxBatch_;
+    const size_t publishBatch_;
+
+    // Producer-only state
+    alignas(64) uint64_t head_ = 0;
+    uint64_t lastPublished_ = 0;
+    uint64_t cachedMin_ = 0;
+    uint64_t producerStalls_ = 0;
+
+    alignas(64) std::atomic<uint64_t> published_{0};
+    std::atomic<bool> closed_{false};
+
+    void publish() {
+        lastPublished_ = head_;
+        published_.store(head_, std::memory_order_release);
+    }
+
+    uint64_t minCursor() const {
+        uint64_t slowest = kDetached;
+        for (const Cursor& cursor : cursors_) slowest = std::min(slowest, cursor.position.load(std::memory_order_acquire));
+        // All detached: nobody to wait for
+        return slowest == kDetached ? head_ : slowest;
+    }
+
+    static void backoff() {
+#if defined(__x86_64__) || defined(_M_X64)
+        _mm_pause();
+#endif
+        std::this_thread::yield();
+    }
+};
+
+// Replay a LOBSTER day once and fan it out to `workers` consumer threads.
+//
+// The calling thread parses the messages, maintains the reference book
+// (verified and healed against `orderbookPath` as in replayVerified, or
+// applied as-is if it is empty) and publishes one FanOutEvent per message.
+// The book is a Book(config.expectedOrders); name a BasicOrderBook with
+// listeners to observe it on that thread.
+// Worker w receives every event, in order, as consume(w, span) calls on its
+// own thread; spans point into the shared ring and are only valid during the
+// call. A parameter sweep assigns several strategy instances to each worker,
+// so the day is parsed and applied once instead of once per instance.
+//
+// The first exception thrown by consume() detaches that worker (the others
+// keep going) and is rethrown after all threads finish.
+template <typename Book = OrderBook, typename Consume>
+FanOutStats runFanOut(const std::string& messagePath, const std::string& orderbookPath, size_t workers,
+                      Consume&& consume, const FanOutConfig& config = FanOutConfig{}) {
+    if (workers == 0) workers = 1;
+    auto ring = std::make_unique<FanOutRing>(config.ringCapacity, workers, config);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w] {
+            try {
+                for (;;) {
+                    std::span<const FanOutEvent> events = ring->acquire(w);
+                    if (events.empty()) return;
+                    consume(w, events);
+                    ring->release(w, events.size());
+                }
+            } catch (...) {
+                ring->detach(w);
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+        });
+    }
+
+    FanOutStats stats;
+    auto timeStart = std::chrono::steady_clock::now();
+    auto publish = [&](const RAWMessage& msg, const Book& book) {
+        FanOutEvent& event = ring->claim();
+        event.msg = msg;
+        event.levelVolume = book.getVolumeAtPrice(msg.price, msg.direction == 1 ? Side::Buy : Side::Sell);
+        event.top = book.getTopOfBook();
+        ring->commit();
+    };
+    struct Hooks : ReplayHooks {
+        decltype(publish)* emit;
+        void afterMessage(const RAWMessage& msg, const Book& book, uint64_t) { (*emit)(msg, book); }
+    };
+
+    std::exception_ptr producerError;
+    try {
+        Book book(config.expectedOrders);
+        if (!orderbookPath.empty()) {
+            Hooks hooks;
+            hooks.emit = &publish;
+            stats.replay = replayVerified(book, messagePath, orderbookPath, hooks);
+        } else {
+            LobsterMessageParser parser(messagePath);
+            RAWMessage msg;
+            while (parser.next(msg)) {
+                book.apply(msg);
+                stats.replay.messages++;
+                publish(msg, book);
+            }
+        }
+    } catch (...) {
+        producerError = std::current_exception();
+    }
+    ring->close();
+    for (auto& t : threads) t.join();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+    if (stats.replay.seconds == 0.0) stats.replay.seconds = stats.seconds;
+
+    if (producerError) std::rethrow_exception(producerError);
+    if (error) std::rethrow_exception(error);
+
+    stats.events = ring->published();
+    stats.producerStalls = ring->producerStalls();
+    for (size_t w = 0; w < workers; ++w) {
+        stats.consumed.push_back(ring->consumed(w));
+        stats.workerStalls.push_back(ring->stalls(w));
+    }
+    return stats;
+}
+
+}
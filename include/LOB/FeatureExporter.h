@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "LOB/ColumnarWriter.h"
+#include "LOB/CSVParser.h"
+#include "LOB/OrderBook.h"
+
+namespace LOB {
+
+// Per-event export of the message and post-event book state through ColumnarWriter.
+//
+// Available columns:
+//   timestamp, type, order_id, size, price, direction       (the message)
+//   bid_px_<i>, bid_sz_<i>, ask_px_<i>, ask_sz_<i>          (level i < depth, 0 = best)
+//   obi, microprice
+// Missing levels are written as INVALID_PRICE / 0.
+class FeatureExporter {
+public:
+    static std::vector<std::string> availableColumns(size_t depth) {
+        std::vector<std::string> names = {"timestamp", "type", "order_id", "size", "price", "direction"};
+        for (size_t i = 0; i < depth; ++i) {
+            names.push_back("bid_px_" + std::to_string(i));
+            names.push_back("bid_sz_" + std::to_string(i));
+            names.push_back("ask_px_" + std::to_string(i));
+            names.push_back("ask_sz_" + std::to_string(i));
+        }
+        names.push_back("obi");
+        names.push_back("microprice");
+        return names;
+    }
+
+    // An empty selection exports every available column
+    FeatureExporter(const std::string& directory, const std::vector<std::string>& selected, size_t depth = 10, size_t chunkRows = 4096)
+        : writer_(directory, buildSpecs(selected.empty() ? availableColumns(depth) : selected, depth), chunkRows) {}
+
+    template <typename... Listeners>
+    void record(const RAWMessage& msg, const BasicOrderBook<Listeners...>& book) {
+        if (maxLevel_ > 0) {
+            bidLevels_ = book.getDepth(Side::Buy, bids_.data(), maxLevel_);
+            askLevels_ = book.getDepth(Side::Sell, asks_.data(), maxLevel_);
+        }
+        TopOfBook top;
+        if (needTop_) top = book.getTopOfBook();
+
+        for (size_t c = 0; c < bindings_.size(); ++c) {
+            const Binding& b = bindings_[c];
+            switch (b.field) {
+                case Field::Timestamp: writer_.set<double>(c, msg.timestamp); break;
+                case Field::Type:      writer_.set<int32_t>(c, msg.type); break;
+                case Field::OrderId:   writer_.set<uint64_t>(c, msg.orderId); break;
+                case Field::Size:      writer_.set<uint64_t>(c, msg.size); break;
+                case Field::MsgPrice:  writer_.set<int64_t>(c, msg.price); break;
+                case Field::Direction: writer_.set<int32_t>(c, msg.direction); break;
+                case Field::BidPx: writer_.set<int64_t>(c, b.level < bidLevels_ ? bids_[b.level].price : INVALID_PRICE); break;
+                case Field::BidSz: writer_.set<uint64_t>(c, b.level < bidLevels_ ? bids_[b.level].volume : 0); break;
+                case Field::AskPx: writer_.set<int64_t>(c, b.level < askLevels_ ? asks_[b.level].price : INVALID_PRICE); break;
+                case Field::AskSz: writer_.set<uint64_t>(c, b.level < askLevels_ ? asks_[b.level].volume : 0); break;
+                case Field::Obi:        writer_.set<double>(c, top.obi()); break;
+                case Field::Microprice: writer_.set<double>(c, top.microprice()); break;
+            }
+        }
+        writer_.commitRow();
+    }
+
+    uint64_t rows() const { return writer_.rows(); }
+    void close() { writer_.close(); }
+
+private:
+    enum class Field : uint8_t {
+        Timestamp, Type, OrderId, Size, MsgPrice, Direction,
+        BidPx, BidSz, AskPx, AskSz,
+        Obi, Microprice
+    };
+
+    struct Binding {
+        Field field;
+        size_t level;
+    };
+
+    std::vector<Binding> bindings_;
+    size_t maxLevel_ = 0;
+    bool needTop_ = false;
+    std::vector<PriceLevel> bids_;
+    std::vector<PriceLevel> asks_;
+    size_t bidLevels_ = 0;
+    size_t askLevels_ = 0;
+    ColumnarWriter writer_;
+
+    // Runs before writer_ is constructed (member initializer order)
+    std::vector<ColumnSpec> buildSpecs(const std::vector<std::string>& names, size_t depth) {
+        std::vector<ColumnSpec> specs;
+        for (const auto& name : names) {
+            Binding b{Field::Timestamp, 0};
+            ColumnType type;
+            if (name == "timestamp")       { b.field = Field::Timestamp; type = ColumnType::Float64; }
+            else if (name == "type")       { b.field = Field::Type;      type = ColumnType::Int32; }
+            else if (name == "order_id")   { b.field = Field::OrderId;   type = ColumnType::UInt64; }
+            else if (name == "size")       { b.field = Field::Size;      type = ColumnType::UInt64; }
+            else if (name == "price")      { b.field = Field::MsgPrice;  type = ColumnType::Int64; }
+            else if (name == "direction")  { b.field = Field::Direction; type = ColumnType::Int32; }
+            else if (name == "obi")        { b.field = Field::Obi;       type = ColumnType::Float64; }
+            else if (name == "microprice") { b.field = Field::Microprice; type = ColumnType::Float64; }
+            else if (parseLevel(name, "bid_px_", depth, b.level)) { b.field = Field::BidPx; type = ColumnType::Int64; }
+            else if (parseLevel(name, "bid_sz_", depth, b.level)) { b.field = Field::BidSz; type = ColumnType::UInt64; }
+            else if (parseLevel(name, "ask_px_", depth, b.level)) { b.field = Field::AskPx; type = ColumnType::Int64; }
+            else if (parseLevel(name, "ask_sz_", depth, b.level)) { b.field = Field::AskSz; type = ColumnType::UInt64; }
+            else throw std::invalid_argument("Unknown export column: " + name);
+
+            if (b.field == Field::Obi || b.field == Field::Microprice) needTop_ = true;
+            if (b.field >= Field::BidPx && b.field <= Field::AskSz && b.level + 1 > maxLevel_) {
+                maxLevel_ = b.level + 1;
+            }
+            bindings_.push_back(b);
+            specs.push_back({name, type});
+        }
+        bids_.resize(maxLevel_);
+        asks_.resize(maxLevel_);
+        return specs;
+    }
+
+    static bool parseLevel(const std::string& name, const char* prefix, size_t depth, size_t& level) {
+        size_t len = std::char_traits<char>::length(prefix);
+        if (name.compare(0, len, prefix) != 0 || name.size() == len) return false;
+        size_t pos = 0;
+        unsigned long value = std::stoul(name.substr(len), &pos);
+        if (pos != name.size() - len || value >= depth) {
+            throw std::invalid_argument("Bad export level: " + name);
+        }
+        level = value;
+        return true;
+    }
+};
+
+}
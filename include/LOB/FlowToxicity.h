@@ -0,0 +1,309 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "LOB/Types.h"
+#include "LOB/BookSnapshot.h"
+#include "LOB/Message.h"
+
+namespace LOB {
+
+// Fixed-capacity ring: push() overwrites the oldest entry once full and hands
+// it back so running sums can be adjusted in O(1). Storage is allocated once.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(size_t capacity) : items_(capacity == 0 ? 1 : capacity) {}
+
+    size_t capacity() const { return items_.size(); }
+    size_t size() const { return size_; }
+    bool full() const { return size_ == items_.size(); }
+
+    // Returns true (and fills `evicted`) if an old entry dropped out
+    bool push(const T& item, T& evicted) {
+        bool dropped = full();
+        if (dropped) evicted = items_[head_];
+        items_[head_] = item;
+        head_ = head_ + 1 == items_.size() ? 0 : head_ + 1;
+        if (!dropped) size_++;
+        return dropped;
+    }
+
+    // i = 0 is the newest entry
+    const T& recent(size_t i) const {
+        size_t idx = head_ + items_.size() - 1 - i;
+        return items_[idx >= items_.size() ? idx - items_.size() : idx];
+    }
+
+    void clear() {
+        head_ = 0;
+        size_ = 0;
+    }
+
+private:
+    std::vector<T> items_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+};
+
+struct ToxicityConfig {
+    Quantity bucketVolume = 50000; // VPIN / Kyle's lambda volume bucket size (shares)
+    size_t vpinBuckets = 50;       // VPIN window, in buckets
+    size_t lambdaBuckets = 50;     // Kyle's lambda regression window, in buckets
+    size_t eventWindow = 10000;    // cancel/trade events kept for the per-level ratios
+    size_t levels = 10;            // price levels tracked for cancel-to-trade (last one is "this deep or deeper")
+    Price tickSize = 100;          // LOBSTER prices are in 1e-4 dollars; 100 = one cent
+};
+
+// Live order-flow toxicity metrics, driven from inside the replay loop.
+//
+// Call onEvent() once per message *after* it has been applied to the book,
+// with the book's new top. The previous call's top is kept as the pre-event
+// state, which is what trades are signed against and cancels are placed by.
+//
+//  - Trade signing: a visible execution (type 4) hits the resting order's side,
+//    so the aggressor is the opposite of its direction. Hidden executions
+//    (type 5) are signed with the quote rule against the pre-trade mid, falling
+//    back to the tick rule (and then the previous sign) at the mid.
+//  - VPIN: signed volume is cut into buckets of exactly bucketVolume shares (a
+//    large trade is split across buckets); VPIN is the mean |buy - sell| /
+//    bucketVolume over the last vpinBuckets buckets.
+//  - Kyle's lambda: OLS slope of the mid change over a bucket on the bucket's
+//    signed volume, over the last lambdaBuckets buckets (price units per share).
+//  - Cancel-to-trade: cancelled volume (types 2/3) per level, measured in ticks
+//    from the same side's pre-event touch, over executed volume, within the
+//    last eventWindow cancel/trade events.
+//
+// Every window is a RingBuffer with running sums, so an event costs O(1)
+// (a trade larger than a bucket costs one step per bucket it closes). Sums are
+// kept in integers (signed volume, mid in half-price units) so evicting from
+// them never drifts.
+class FlowToxicity {
+public:
+    explicit FlowToxicity(const ToxicityConfig& config = ToxicityConfig{})
+        : config_(config),
+          vpinWindow_(config.vpinBuckets),
+          lambdaWindow_(config.lambdaBuckets),
+          events_(config.eventWindow),
+          cancelVolume_(config.levels == 0 ? 1 : config.levels, 0),
+          tradeVolumeAt_(config.levels == 0 ? 1 : config.levels, 0) {
+        if (config.bucketVolume == 0) throw std::invalid_argument("FlowToxicity: bucketVolume must be > 0");
+        if (config.tickSize <= 0) throw std::invalid_argument("FlowToxicity: tickSize must be > 0");
+    }
+
+    void onEvent(const RAWMessage& msg, const TopOfBook& top) {
+        const bool isTrade = (msg.type == 4 || msg.type == 5);
+        int sign = 0;
+        // Signing and level placement use the pre-event book
+        if (isTrade) {
+            sign = recordTrade(msg);
+        } else if (msg.type == 2 || msg.type == 3) {
+            Side side = msg.direction == 1 ? Side::Buy : Side::Sell;
+            addWindowEvent(WindowEvent{levelOf(msg.price, side), false, msg.size});
+        }
+        if (!bucketHasStart_ && haveMid_) {
+            bucketStartMid2_ = mid2_;
+            bucketHasStart_ = true;
+        }
+
+        prev_ = top;
+        if (top.bidPrice != INVALID_PRICE && top.askPrice != INVALID_PRICE) {
+            mid2_ = top.bidPrice + top.askPrice;
+            haveMid_ = true;
+        }
+
+        // Buckets close on the post-event mid, so a trade's own impact lands in its bucket
+        if (isTrade) fillBuckets(msg.size, sign);
+    }
+
+    const ToxicityConfig& config() const { return config_; }
+
+    // --- Trade signing (cumulative) ---
+    int lastTradeSign() const { return lastSign_; }
+    Quantity buyVolume() const { return buyVolume_; }
+    Quantity sellVolume() const { return sellVolume_; }
+    uint64_t tradeCount() const { return tradeCount_; }
+
+    // --- VPIN ---
+    // 0 until the first bucket completes; averages over the buckets seen so far until the window fills
+    double vpin() const {
+        if (vpinWindow_.size() == 0) return 0.0;
+        return static_cast<double>(imbalanceSum_) /
+               (static_cast<double>(vpinWindow_.size()) * static_cast<double>(config_.bucketVolume));
+    }
+    size_t bucketsCompleted() const { return bucketsCompleted_; }
+
+    // --- Kyle's lambda ---
+    // Price units per share; 0 until two buckets with varying flow are available
+    double kyleLambda() const {
+        const double n = static_cast<double>(lambdaWindow_.size());
+        if (n < 2) return 0.0;
+        const double sx = static_cast<double>(sumX_), sy = static_cast<double>(sumY_);
+        const double sxx = static_cast<double>(sumXX_), sxy = static_cast<double>(sumXY_);
+        const double varX = n * sxx - sx * sx;
+        if (varX <= 0.0) return 0.0;
+        // y is in half-price units (doubled mid)
+        return (n * sxy - sx * sy) / varX / 2.0;
+    }
+
+    // --- Cancel-to-trade, over the event window ---
+    size_t levels() const { return cancelVolume_.size(); }
+    Quantity cancelVolume(size_t level) const { return cancelVolume_[level]; }
+    // Executed visible volume at `level` ticks from the touch (almost always level 0)
+    Quantity tradeVolume(size_t level) const { return tradeVolumeAt_[level]; }
+    Quantity windowTradeVolume() const { return windowTradeVolume_; }
+
+    // Cancelled volume at `level` per executed share in the window (0 if nothing traded)
+    double cancelToTradeRatio(size_t level) const {
+        return windowTradeVolume_ ? static_cast<double>(cancelVolume_[level]) / static_cast<double>(windowTradeVolume_) : 0.0;
+    }
+
+private:
+    struct Bucket {
+        int64_t imbalance = 0; // |buy - sell|
+        int64_t flow = 0;      // buy - sell
+        int64_t midChange = 0; // doubled-mid units
+    };
+
+    struct WindowEvent {
+        uint32_t level = 0; // kNoLevel for hidden executions
+        bool trade = false;
+        Quantity size = 0;
+    };
+
+    static constexpr uint32_t kNoLevel = UINT32_MAX;
+
+    ToxicityConfig config_;
+    TopOfBook prev_;
+    int64_t mid2_ = 0;
+    bool haveMid_ = false;
+
+    int lastSign_ = 0;
+    Price lastTradePrice_ = INVALID_PRICE;
+    Quantity buyVolume_ = 0;
+    Quantity sellVolume_ = 0;
+    uint64_t tradeCount_ = 0;
+
+    // Open bucket
+    Quantity bucketFilled_ = 0;
+    int64_t bucketFlow_ = 0;
+    int64_t bucketStartMid2_ = 0;
+    bool bucketHasStart_ = false;
+    size_t bucketsCompleted_ = 0;
+
+    RingBuffer<Bucket> vpinWindow_;
+    int64_t imbalanceSum_ = 0;
+
+    RingBuffer<Bucket> lambdaWindow_;
+    int64_t sumX_ = 0, sumY_ = 0, sumXX_ = 0, sumXY_ = 0;
+
+    RingBuffer<WindowEvent> events_;
+    std::vector<Quantity> cancelVolume_;
+    std::vector<Quantity> tradeVolumeAt_;
+    Quantity windowTradeVolume_ = 0;
+
+    int signTrade(const RAWMessage& msg) {
+        if (msg.type == 4) return msg.direction == 1 ? -1 : 1;
+        // Hidden: quote rule, then tick rule
+        if (haveMid_) {
+            const int64_t px2 = msg.price * 2;
+            if (px2 > mid2_) return 1;
+            if (px2 < mid2_) return -1;
+        }
+        if (lastTradePrice_ != INVALID_PRICE) {
+            if (msg.price > lastTradePrice_) return 1;
+            if (msg.price < lastTradePrice_) return -1;
+        }
+        return lastSign_ != 0 ? lastSign_ : 1;
+    }
+
+    // Ticks from the same side's pre-event touch, clamped to the last level
+    uint32_t levelOf(Price price, Side side) const {
+        const uint32_t deepest = static_cast<uint32_t>(cancelVolume_.size() - 1);
+        const Price best = side == Side::Buy ? prev_.bidPrice : prev_.askPrice;
+        if (best == INVALID_PRICE) return deepest;
+        Price distance = side == Side::Buy ? best - price : price - best;
+        if (distance <= 0) return 0;
+        Price ticks = distance / config_.tickSize;
+        return ticks >= static_cast<Price>(deepest) ? deepest : static_cast<uint32_t>(ticks);
+    }
+
+    int recordTrade(const RAWMessage& msg) {
+        const int sign = signTrade(msg);
+        lastSign_ = sign;
+        lastTradePrice_ = msg.price;
+        tradeCount_++;
+        (sign > 0 ? buyVolume_ : sellVolume_) += msg.size;
+
+        Side restingSide = msg.direction == 1 ? Side::Buy : Side::Sell;
+        addWindowEvent(WindowEvent{msg.type == 4 ? levelOf(msg.price, restingSide) : kNoLevel, true, msg.size});
+        return sign;
+    }
+
+    // A trade larger than the open bucket's remainder closes several buckets;
+    // only the first carries the mid change, the rest start and end on the same mid.
+    void fillBuckets(Quantity size, int sign) {
+        Quantity remaining = size;
+        while (remaining > 0) {
+            Quantity take = std::min(remaining, config_.bucketVolume - bucketFilled_);
+            bucketFilled_ += take;
+            bucketFlow_ += sign * static_cast<int64_t>(take);
+            remaining -= take;
+            if (bucketFilled_ == config_.bucketVolume) closeBucket();
+        }
+    }
+
+    void closeBucket() {
+        Bucket bucket;
+        bucket.flow = bucketFlow_;
+        bucket.imbalance = bucketFlow_ < 0 ? -bucketFlow_ : bucketFlow_;
+        bucket.midChange = (bucketHasStart_ && haveMid_) ? mid2_ - bucketStartMid2_ : 0;
+
+        Bucket evicted;
+        if (vpinWindow_.push(bucket, evicted)) imbalanceSum_ -= evicted.imbalance;
+        imbalanceSum_ += bucket.imbalance;
+
+        if (lambdaWindow_.push(bucket, evicted)) removeObservation(evicted);
+        sumX_ += bucket.flow;
+        sumY_ += bucket.midChange;
+        sumXX_ += bucket.flow * bucket.flow;
+        sumXY_ += bucket.flow * bucket.midChange;
+
+        bucketsCompleted_++;
+        bucketFilled_ = 0;
+        bucketFlow_ = 0;
+        bucketStartMid2_ = mid2_;
+        bucketHasStart_ = haveMid_;
+    }
+
+    void removeObservation(const Bucket& b) {
+        sumX_ -= b.flow;
+        sumY_ -= b.midChange;
+        sumXX_ -= b.flow * b.flow;
+        sumXY_ -= b.flow * b.midChange;
+    }
+
+    void addWindowEvent(const WindowEvent& event) {
+        WindowEvent evicted;
+        if (events_.push(event, evicted)) account(evicted, -1);
+        account(event, 1);
+    }
+
+    void account(const WindowEvent& e, int direction) {
+        const Quantity delta = e.size;
+        if (e.trade) {
+            windowTradeVolume_ = direction > 0 ? windowTradeVolume_ + delta : windowTradeVolume_ - delta;
+            if (e.level != kNoLevel) {
+                Quantity& v = tradeVolumeAt_[e.level];
+                v = direction > 0 ? v + delta : v - delta;
+            }
+        } else {
+            Quantity& v = cancelVolume_[e.level];
+            v = direction > 0 ? v + delta : v - delta;
+        }
+    }
+};
+
+}
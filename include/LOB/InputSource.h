@@ -0,0 +1,300 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LOB/MemoryMappedFile.h"
+
+#ifdef LOB_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef LOB_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace LOB {
+
+// A text input delivered as a sequence of chunks that each hold whole lines.
+// A chunk stays valid until the next call to nextChunk().
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+    virtual bool nextChunk(const char*& begin, const char*& end) = 0;
+};
+
+// Uncompressed file: the whole mapping is a single chunk (zero copy)
+class MappedInputSource : public InputSource {
+public:
+    explicit MappedInputSource(const std::string& path) : file_(path) {}
+
+    bool nextChunk(const char*& begin, const char*& end) override {
+        if (done_) return false;
+        done_ = true;
+        begin = file_.data();
+        end = file_.data() + file_.size();
+        return true;
+    }
+
+private:
+    MemoryMappedFile file_;
+    bool done_ = false;
+};
+
+// Streaming decoders used by DecompressingInputSource.
+// read() fills up to `capacity` bytes and returns 0 at end of stream.
+class Decoder {
+public:
+    virtual ~Decoder() = default;
+    virtual size_t read(char* dst, size_t capacity) = 0;
+};
+
+#ifdef LOB_HAVE_ZLIB
+class GzipDecoder : public Decoder {
+public:
+    explicit GzipDecoder(const std::string& path) {
+        file_ = gzopen(path.c_str(), "rb");
+        if (!file_) throw std::runtime_error("Failed to open file: " + path);
+        gzbuffer(file_, 1 << 20);
+    }
+    ~GzipDecoder() override { gzclose(file_); }
+
+    size_t read(char* dst, size_t capacity) override {
+        size_t total = 0;
+        while (total < capacity) {
+            unsigned request = static_cast<unsigned>(std::min<size_t>(capacity - total, 1u << 30));
+            int n = gzread(file_, dst + total, request);
+            if (n < 0) {
+                int err;
+                throw std::runtime_error(std::string("gzip decode failed: ") + gzerror(file_, &err));
+            }
+            if (n == 0) {
+                // A clean end sets gzeof; a stream cut short mid-member reports Z_BUF_ERROR
+                int err;
+                const char* message = gzerror(file_, &err);
+                if (err == Z_BUF_ERROR) throw std::runtime_error("truncated gzip stream");
+                if (err != Z_OK || !gzeof(file_)) throw std::runtime_error(std::string("gzip decode failed: ") + message);
+                break;
+            }
+            total += static_cast<size_t>(n);
+        }
+        return total;
+    }
+
+private:
+    gzFile file_;
+};
+#endif
+
+#ifdef LOB_HAVE_ZSTD
+class ZstdDecoder : public Decoder {
+public:
+    explicit ZstdDecoder(const std::string& path) : in_(ZSTD_DStreamInSize()) {
+        file_ = std::fopen(path.c_str(), "rb");
+        if (!file_) throw std::runtime_error("Failed to open file: " + path);
+        ctx_ = ZSTD_createDCtx();
+    }
+    ~ZstdDecoder() override {
+        ZSTD_freeDCtx(ctx_);
+        std::fclose(file_);
+    }
+
+    // Once the file is exhausted, keeps calling ZSTD_decompressStream with no
+    // input to drain what the context still holds (up to a block), until the
+    // frame reports complete. A frame still open when nothing more comes out
+    // means the file was cut short.
+    size_t read(char* dst, size_t capacity) override {
+        ZSTD_outBuffer out{dst, capacity, 0};
+        while (out.pos < out.size) {
+            if (input_.pos == input_.size && !fileDone_) {
+                size_t n = std::fread(in_.data(), 1, in_.size(), file_);
+                if (n == 0) {
+                    if (std::ferror(file_)) throw std::runtime_error("zstd read failed");
+                    fileDone_ = true;
+                }
+                input_ = ZSTD_inBuffer{in_.data(), n, 0};
+            }
+            if (fileDone_ && input_.pos == input_.size && !frameOpen_) break;
+            const size_t before = out.pos;
+            size_t ret = ZSTD_decompressStream(ctx_, &out, &input_);
+            if (ZSTD_isError(ret)) {
+                throw std::runtime_error(std::string("zstd decode failed: ") + ZSTD_getErrorName(ret));
+            }
+            frameOpen_ = ret != 0;
+            if (fileDone_ && input_.pos == input_.size && out.pos == before && frameOpen_) {
+                throw std::runtime_error("truncated zstd stream");
+            }
+        }
+        return out.pos;
+    }
+
+private:
+    std::FILE* file_;
+    ZSTD_DCtx* ctx_;
+    std::vector<char> in_;
+    ZSTD_inBuffer input_{nullptr, 0, 0};
+    bool fileDone_ = false;
+    bool frameOpen_ = false; // last ZSTD_decompressStream return was nonzero: frame not finished or not flushed
+};
+#endif
+
+// Decompresses on a background thread into a small ring of page-aligned buffers.
+//
+// Each published buffer ends on a line boundary (the partial last line is
+// carried into the next buffer) and is followed by a '\0', so the parser's
+// strtod/strtoll calls never run past it. Decompression of buffer N+1 overlaps
+// with parsing/book updates on buffer N; nothing touches the disk besides the
+// compressed input.
+class DecompressingInputSource : public InputSource {
+public:
+    static constexpr size_t kPageSize = 4096;
+
+    DecompressingInputSource(std::unique_ptr<Decoder> decoder, size_t bufferSize = 4 << 20, size_t bufferCount = 4)
+        : decoder_(std::move(decoder)) {
+        bufferSize_ = (bufferSize + kPageSize - 1) & ~(kPageSize - 1);
+        for (size_t i = 0; i < bufferCount; ++i) {
+            buffers_.push_back(Buffer{static_cast<char*>(::operator new(bufferSize_, std::align_val_t(kPageSize))), 0});
+            free_.push_back(&buffers_.back());
+        }
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~DecompressingInputSource() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        freeCv_.notify_all();
+        worker_.join();
+        for (Buffer& buffer : buffers_) {
+            ::operator delete(buffer.data, std::align_val_t(kPageSize));
+        }
+    }
+
+    bool nextChunk(const char*& begin, const char*& end) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (inUse_) {
+            free_.push_back(inUse_);
+            inUse_ = nullptr;
+            freeCv_.notify_one();
+        }
+        readyCv_.wait(lock, [this] { return !ready_.empty() || finished_; });
+        if (ready_.empty()) {
+            if (error_) std::rethrow_exception(error_);
+            return false;
+        }
+        inUse_ = ready_.front();
+        ready_.pop_front();
+        begin = inUse_->data;
+        end = inUse_->data + inUse_->size;
+        return true;
+    }
+
+private:
+    struct Buffer {
+        char* data;
+        size_t size;
+    };
+
+    std::unique_ptr<Decoder> decoder_;
+    size_t bufferSize_;
+    std::deque<Buffer> buffers_; // stable addresses
+    std::thread worker_;
+
+    std::mutex mutex_;
+    std::condition_variable readyCv_;
+    std::condition_variable freeCv_;
+    std::vector<Buffer*> free_;
+    std::deque<Buffer*> ready_;
+    Buffer* inUse_ = nullptr;
+    bool stop_ = false;
+    bool finished_ = false;
+    std::exception_ptr error_;
+
+    void run() {
+        std::vector<char> carry;
+        try {
+            for (;;) {
+                Buffer* buffer;
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    freeCv_.wait(lock, [this] { return !free_.empty() || stop_; });
+                    if (stop_) break;
+                    buffer = free_.back();
+                    free_.pop_back();
+                }
+
+                // Leave one byte for the terminator
+                const size_t capacity = bufferSize_ - 1;
+                std::memcpy(buffer->data, carry.data(), carry.size());
+                size_t filled = carry.size();
+                filled += decoder_->read(buffer->data + filled, capacity - filled);
+                const bool eof = filled < capacity;
+
+                size_t cut = filled;
+                if (!eof) {
+                    while (cut > 0 && buffer->data[cut - 1] != '\n') --cut;
+                    if (cut == 0) throw std::runtime_error("Input line longer than decompression buffer");
+                }
+                carry.assign(buffer->data + cut, buffer->data + filled);
+                buffer->data[cut] = '\0';
+                buffer->size = cut;
+
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (cut > 0) {
+                    ready_.push_back(buffer);
+                } else {
+                    free_.push_back(buffer);
+                }
+                if (eof) {
+                    finished_ = true;
+                    readyCv_.notify_one();
+                    return;
+                }
+                readyCv_.notify_one();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            error_ = std::current_exception();
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+        readyCv_.notify_one();
+    }
+};
+
+inline bool endsWith(const std::string& value, const std::string& suffix) {
+    return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Open a LOBSTER text file: `.gz` / `.zst` are streamed through a background
+// decompressor, anything else is memory-mapped.
+inline std::unique_ptr<InputSource> openInput(const std::string& path) {
+    if (endsWith(path, ".gz")) {
+#ifdef LOB_HAVE_ZLIB
+        return std::make_unique<DecompressingInputSource>(std::make_unique<GzipDecoder>(path));
+#else
+        throw std::runtime_error("Built without zlib; cannot read " + path);
+#endif
+    }
+    if (endsWith(path, ".zst")) {
+#ifdef LOB_HAVE_ZSTD
+        return std::make_unique<DecompressingInputSource>(std::make_unique<ZstdDecoder>(path));
+#else
+        throw std::runtime_error("Built without zstd; cannot read " + path);
+#endif
+    }
+    return std::make_unique<MappedInputSource>(path);
+}
+
+}
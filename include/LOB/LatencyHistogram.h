@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace LOB {
+
+// Fixed-size log-linear histogram of latencies in nanoseconds (HdrHistogram-style).
+//
+// Values below 2 * kSubBuckets are counted exactly. Above that, each power of
+// two is split into kSubBuckets equal buckets, so a reported percentile is
+// within 1/kSubBuckets (~3%) of the true value. record() is a couple of shifts
+// and an increment into a preallocated array: no allocation, safe to call on
+// a hot path.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBits = 5;
+    static constexpr uint64_t kSubBuckets = uint64_t(1) << kSubBits;
+    static constexpr size_t kBuckets = 2 * kSubBuckets + (63 - kSubBits) * kSubBuckets;
+
+    void record(int64_t ns) {
+        const uint64_t v = ns > 0 ? static_cast<uint64_t>(ns) : 0;
+        counts_[bucketOf(v)]++;
+        count_++;
+        sum_ += v;
+        min_ = std::min(min_, v);
+        max_ = std::max(max_, v);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < kBuckets; ++i) counts_[i] += other.counts_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+
+    void reset() { *this = LatencyHistogram{}; }
+
+    uint64_t count() const { return count_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    // Smallest recorded bucket bound at or above fraction q (0..1) of the samples
+    uint64_t percentile(double q) const {
+        if (count_ == 0) return 0;
+        const double clamped = std::clamp(q, 0.0, 1.0);
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(clamped * static_cast<double>(count_) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) return std::clamp(upperBound(i), min(), max_);
+        }
+        return max_;
+    }
+
+private:
+    std::array<uint64_t, kBuckets> counts_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t min_ = std::numeric_limits<uint64_t>::max();
+    uint64_t max_ = 0;
+
+    static size_t bucketOf(uint64_t v) {
+        if (v < 2 * kSubBuckets) return static_cast<size_t>(v);
+        const unsigned shift = static_cast<unsigned>(std::bit_width(v)) - 1 - kSubBits;
+        // (v >> shift) is in [kSubBuckets, 2 * kSubBuckets)
+        return static_cast<size_t>(kSubBuckets * shift + (v >> shift));
+    }
+
+    static uint64_t upperBound(size_t bucket) {
+        if (bucket < 2 * kSubBuckets) return bucket;
+        const unsigned shift = static_cast<unsigned>(bucket / kSubBuckets) - 1;
+        const uint64_t top = kSubBuckets + bucket % kSubBuckets;
+        return ((top + 1) << shift) - 1;
+    }
+};
+
+}
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "LOB/BookSnapshot.h"
+#include "LOB/OrderBook.h"
+
+namespace LOB {
+
+// Market-by-price (L2) incremental feed: the top `Depth` levels of each side
+// as a stream of level inserts / updates / deletes.
+//
+// Frame (all integers are LEB128 varints):
+//   header     (entryCount << 1) | isKeyframe
+//   time       keyframe: event time in ns; delta frame: zigzag(ns since the previous frame)
+//   entries    key = zigzag(price - previous price on that side) << 3 | side << 2 | op
+//              size (omitted for deletes)
+// side: 0 = bid, 1 = ask. op: 0 = insert, 1 = update, 2 = delete.
+//
+// Prices are offsets from the previous price on the same side, so entries near
+// the touch take 1-3 bytes. A keyframe lists every level as an insert into an
+// empty book and resets the price references, so a decoder can start (or
+// resynchronize) at any keyframe. Within a delta frame deletes come first,
+// so applying entries in order never overflows Depth levels.
+enum class MbpOp : uint8_t { Insert = 0, Update = 1, Delete = 2 };
+
+inline uint64_t zigzagEncode(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+inline int64_t zigzagDecode(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+inline void putVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v) | 0x80);
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+// Reads one varint, advancing `p`; throws on truncated or overlong input
+inline uint64_t getVarint(const uint8_t*& p, const uint8_t* end) {
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        if (p >= end) throw std::runtime_error("MBP: truncated varint");
+        const uint8_t byte = *p++;
+        v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return v;
+    }
+    throw std::runtime_error("MBP: varint too long");
+}
+
+inline int64_t toNanoseconds(double seconds) { return std::llround(seconds * 1e9); }
+
+// Turns successive states of a book into MBP frames.
+//
+// Call encode() after each event (e.g. from a replay hook). It diffs the
+// book's top Depth levels against the last encoded state and appends a frame
+// only if something in that window changed; changes deeper in the book are
+// invisible to an L2 depth-N consumer and cost nothing.
+template <size_t Depth = 10>
+class MbpEncoder {
+public:
+    // A keyframe is emitted as the first frame and then every `keyframeInterval` frames
+    // (frames 0, N, 2N, ...; 1 makes every frame a keyframe)
+    explicit MbpEncoder(size_t keyframeInterval = 1024) : keyframeInterval_(keyframeInterval == 0 ? 1 : keyframeInterval) {}
+
+    // Make the next frame a keyframe (e.g. when a new subscriber joins)
+    void requestKeyframe() { sinceKeyframe_ = keyframeInterval_; }
+
+    // Appends at most one frame to `out`; returns true if one was written
+    template <typename... Listeners>
+    bool encode(const BasicOrderBook<Listeners...>& book, double timestamp, std::vector<uint8_t>& out) {
+        DepthSnapshot<Depth> next;
+        next.bidLevels = static_cast<uint32_t>(book.getDepth(Side::Buy, next.bids, Depth));
+        next.askLevels = static_cast<uint32_t>(book.getDepth(Side::Sell, next.asks, Depth));
+        return encode(next, toNanoseconds(timestamp), out);
+    }
+
+    bool encode(const DepthSnapshot<Depth>& next, int64_t timestampNs, std::vector<uint8_t>& out) {
+        // sinceKeyframe_ counts the delta frames since the last keyframe
+        if (frames_ == 0 || sinceKeyframe_ + 1 >= keyframeInterval_) {
+            writeKeyframe(next, timestampNs, out);
+        } else {
+            entryCount_ = 0;
+            diffSide(0, last_.bids, last_.bidLevels, next.bids, next.bidLevels, true);
+            diffSide(1, last_.asks, last_.askLevels, next.asks, next.askLevels, true);
+            diffSide(0, last_.bids, last_.bidLevels, next.bids, next.bidLevels, false);
+            diffSide(1, last_.asks, last_.askLevels, next.asks, next.askLevels, false);
+            if (entryCount_ == 0) return false;
+
+            putVarint(out, static_cast<uint64_t>(entryCount_) << 1);
+            putVarint(out, zigzagEncode(timestampNs - lastTimeNs_));
+            for (size_t i = 0; i < entryCount_; ++i) writeEntry(entries_[i], out);
+            sinceKeyframe_++;
+        }
+        last_ = next;
+        lastTimeNs_ = timestampNs;
+        frames_++;
+        entriesWritten_ += entryCount_;
+        return true;
+    }
+
+    uint64_t frames() const { return frames_; }
+    uint64_t keyframes() const { return keyframes_; }
+    uint64_t entries() const { return entriesWritten_; }
+
+private:
+    struct Entry {
+        uint8_t side;
+        MbpOp op;
+        Price price;
+        Quantity size;
+    };
+
+    size_t keyframeInterval_;
+    size_t sinceKeyframe_ = 0;
+    uint64_t frames_ = 0;
+    uint64_t keyframes_ = 0;
+    uint64_t entriesWritten_ = 0;
+    DepthSnapshot<Depth> last_;
+    int64_t lastTimeNs_ = 0;
+    Price reference_[2] = {0, 0};
+    Entry entries_[4 * Depth];
+    size_t entryCount_ = 0;
+
+    // Merge of two best-first level lists. The deletes pass emits levels that
+    // left the window; the other pass emits new levels and changed sizes.
+    void diffSide(uint8_t side, const PriceLevel* old, size_t oldCount, const PriceLevel* now, size_t nowCount, bool deletes) {
+        // Bids: higher is better; asks: lower is better
+        auto better = [side](Price a, Price b) { return side == 0 ? a > b : a < b; };
+        size_t i = 0, j = 0;
+        while (i < oldCount || j < nowCount) {
+            if (j == nowCount || (i < oldCount && better(old[i].price, now[j].price))) {
+                if (deletes) entries_[entryCount_++] = Entry{side, MbpOp::Delete, old[i].price, 0};
+                i++;
+            } else if (i == oldCount || better(now[j].price, old[i].price)) {
+                if (!deletes) entries_[entryCount_++] = Entry{side, MbpOp::Insert, now[j].price, now[j].volume};
+                j++;
+            } else {
+                if (!deletes && old[i].volume != now[j].volume) {
+                    entries_[entryCount_++] = Entry{side, MbpOp::Update, now[j].price, now[j].volume};
+                }
+                i++;
+                j++;
+            }
+        }
+    }
+
+    void writeEntry(const Entry& e, std::vector<uint8_t>& out) {
+        const int64_t offset = e.price - reference_[e.side];
+        reference_[e.side] = e.price;
+        putVarint(out, zigzagEncode(offset) << 3 | static_cast<uint64_t>(e.side) << 2 | static_cast<uint64_t>(e.op));
+        if (e.op != MbpOp::Delete) putVarint(out, e.size);
+    }
+
+    void writeKeyframe(const DepthSnapshot<Depth>& next, int64_t timestampNs, std::vector<uint8_t>& out) {
+        entryCount_ = 0;
+        for (size_t i = 0; i < next.bidLevels; ++i) entries_[entryCount_++] = Entry{0, MbpOp::Insert, next.bids[i].price, next.bids[i].volume};
+        for (size_t i = 0; i < next.askLevels; ++i) entries_[entryCount_++] = Entry{1, MbpOp::Insert, next.asks[i].price, next.asks[i].volume};
+
+        reference_[0] = reference_[1] = 0;
+        putVarint(out, static_cast<uint64_t>(entryCount_) << 1 | 1);
+        putVarint(out, static_cast<uint64_t>(timestampNs));
+        for (size_t i = 0; i < entryCount_; ++i) writeEntry(entries_[i], out);
+        sinceKeyframe_ = 0;
+        keyframes_++;
+    }
+};
+
+// Rebuilds the depth-N book from an MBP byte stream, one frame per next().
+//
+// Frames before the first keyframe are skipped (the decoder is not synced
+// yet), so decoding may start at any frame boundary. Malformed input, or a
+// delta that does not fit the current book, throws std::runtime_error.
+template <size_t Depth = 10>
+class MbpDecoder {
+public:
+    MbpDecoder(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+    explicit MbpDecoder(const std::vector<uint8_t>& data) : MbpDecoder(data.data(), data.size()) {}
+
+    // Decodes the next frame; false at the end of the input
+    bool next() {
+        while (p_ < end_) {
+            const uint64_t header = getVarint(p_, end_);
+            const uint64_t count = header >> 1;
+            keyframe_ = header & 1;
+            const uint64_t time = getVarint(p_, end_);
+
+            if (keyframe_) {
+                book_ = DepthSnapshot<Depth>{};
+                reference_[0] = reference_[1] = 0;
+                timeNs_ = static_cast<int64_t>(time);
+                synced_ = true;
+            } else {
+                timeNs_ += zigzagDecode(time);
+            }
+            for (uint64_t i = 0; i < count; ++i) readEntry();
+            if (synced_) return true;
+        }
+        return false;
+    }
+
+    const DepthSnapshot<Depth>& book() const { return book_; }
+    bool keyframe() const { return keyframe_; }
+    bool synced() const { return synced_; }
+    int64_t timestampNs() const { return timeNs_; }
+    double timestamp() const { return static_cast<double>(timeNs_) * 1e-9; }
+    size_t remaining() const { return static_cast<size_t>(end_ - p_); }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+    DepthSnapshot<Depth> book_;
+    Price reference_[2] = {0, 0};
+    int64_t timeNs_ = 0;
+    bool keyframe_ = false;
+    bool synced_ = false;
+
+    void readEntry() {
+        const uint64_t key = getVarint(p_, end_);
+        const auto op = static_cast<MbpOp>(key & 3);
+        const uint8_t side = (key >> 2) & 1;
+        const Price price = reference_[side] + zigzagDecode(key >> 3);
+        reference_[side] = price;
+        const Quantity size = op == MbpOp::Delete ? 0 : getVarint(p_, end_);
+        // Deltas before the first keyframe refer to a book we never saw
+        if (!synced_) return;
+
+        PriceLevel* levels = side == 0 ? book_.bids : book_.asks;
+        uint32_t& count = side == 0 ? book_.bidLevels : book_.askLevels;
+        // First level not better than `price`
+        uint32_t pos = 0;
+        while (pos < count && (side == 0 ? levels[pos].price > price : levels[pos].price < price)) pos++;
+        const bool found = pos < count && levels[pos].price == price;
+
+        switch (op) {
+            case MbpOp::Insert:
+                if (found || count == Depth) throw std::runtime_error("MBP: insert does not fit the book");
+                for (uint32_t k = count; k > pos; --k) levels[k] = levels[k - 1];
+                levels[pos] = PriceLevel{price, size};
+                count++;
+                break;
+            case MbpOp::Update:
+                if (!found) throw std::runtime_error("MBP: update of a missing level");
+                levels[pos].volume = size;
+                break;
+            case MbpOp::Delete:
+                if (!found) throw std::runtime_error("MBP: delete of a missing level");
+                for (uint32_t k = pos; k + 1 < count; ++k) levels[k] = levels[k + 1];
+                count--;
+                break;
+            default:
+                throw std::runtime_error("MBP: bad entry op");
+        }
+    }
+};
+
+}
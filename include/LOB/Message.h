@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace LOB {
+
+// One LOBSTER message-file row
+// Type: 1 Add, 2 Partial Cancel, 3 Delete, 4 Execution, 5 Hidden Execution, 7 Trading Halt
+// Direction: 1 Buy, -1 Sell
+struct RAWMessage {
+    double timestamp;
+    int type;
+    uint64_t orderId;
+    uint64_t size;
+    int64_t price;
+    int direction;
+};
+
+}
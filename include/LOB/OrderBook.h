@@ -1,20 +1,56 @@
 #pragma once
 
+#include <cmath>
 #include <map>
-#include <unordered_map>
 #include <functional>
+#include <span>
+#include <tuple>
+#include <type_traits>
 #include "LOB/Types.h"
 #include "LOB/Order.h"
 #include "LOB/Limit.h"
 #include "LOB/SlabAllocator.h"
+#include "LOB/BookSnapshot.h"
+#include "LOB/DepthLadder.h"
+#include "LOB/OrderIndex.h"
+#include "LOB/Message.h"
+#include "LOB/BookListener.h"
 
 namespace LOB {
 
-class OrderBook {
+// Approximate heap footprint of one book, in bytes
+struct BookMemory {
+    size_t orderSlab = 0;  // slab blocks held (live orders plus free slots)
+    size_t orderIndex = 0; // OrderID hash table
+    size_t levels = 0;     // Limit objects and their map nodes (estimated per level)
+    size_t ladders = 0;    // contiguous depth ladders
+
+    size_t total() const { return orderSlab + orderIndex + levels + ladders; }
+};
+
+// Limit order book. Listeners (see BookListener) receive typed callbacks on
+// every change; they are part of the type, so OrderBook (no listeners) has no
+// notification code at all.
+template <typename... Listeners>
+class BasicOrderBook {
 public:
-    OrderBook() : orderAllocator_(1000000) {}
-    
-    ~OrderBook() {
+    // expectedOrders sizes the order slab and index up front; the slab grows on
+    // demand from the process-wide block pool and gives fully free blocks back,
+    // never dropping below the hint. Keep the default for a single large replay;
+    // use a few hundred for books kept for every listed symbol.
+    explicit BasicOrderBook(size_t expectedOrders = 1000000)
+        : orderLookup_(expectedOrders), orderAllocator_(expectedOrders),
+          bidLadder_(Side::Buy, ladderReserve(expectedOrders)), askLadder_(Side::Sell, ladderReserve(expectedOrders)) {}
+
+    BasicOrderBook(size_t expectedOrders, Listeners... listeners)
+        requires(sizeof...(Listeners) > 0)
+        : listeners_(std::move(listeners)...), orderLookup_(expectedOrders), orderAllocator_(expectedOrders),
+          bidLadder_(Side::Buy, ladderReserve(expectedOrders)), askLadder_(Side::Sell, ladderReserve(expectedOrders)) {}
+
+    BasicOrderBook(const BasicOrderBook&) = delete;
+    BasicOrderBook& operator=(const BasicOrderBook&) = delete;
+
+    ~BasicOrderBook() {
         for (auto& pair : bids_) {
             delete pair.second;
         }
@@ -23,30 +59,24 @@ public:
         }
     }
     
+    // The attached listener of type L
+    template <typename L>
+    L& listener() { return std::get<L>(listeners_); }
+    template <typename L>
+    const L& listener() const { return std::get<L>(listeners_); }
+
     // Helper to find limit (Public for Main healing)
     Limit* getOrCreateLimit(Price price, Side side) {
-        if (side == Side::Buy) {
-            auto it = bids_.find(price);
-            if (it != bids_.end()) return it->second;
-            
-            Limit* limit = new Limit(price); 
-            bids_[price] = limit;
-            return limit;
-        } else {
-            auto it = asks_.find(price);
-            if (it != asks_.end()) return it->second;
-            
-            Limit* limit = new Limit(price);
-            asks_[price] = limit;
-            return limit;
-        }
+        BestWatch watch(*this);
+        return findOrCreateLimit(price, side);
     }
 
     // Add a new order
     // For LOBSTER, 'Add' means a new limit order submission
     // We assume the parser provides valid inputs.
     void addOrder(OrderID id, Price price, Quantity size, Side side, uint64_t timestamp) {
-        if (orderLookup_.find(id) != orderLookup_.end()) {
+        BestWatch watch(*this);
+        if (orderLookup_.find(id) != nullptr) {
             return; // Duplicate ID, ignore or handle error
         }
 
@@ -63,17 +93,21 @@ public:
         order->parentLimit = nullptr;
 
         // Find or create Limit level
-        Limit* limit = getOrCreateLimit(price, side);
+        Limit* limit = findOrCreateLimit(price, side);
         limit->addOrder(order);
+        syncLevel(side, limit);
         
         // Add to O(1) lookup
-        orderLookup_[id] = order;
+        orderLookup_.insert(id, order);
+        notify([&](auto& l) { l.onOrderAdded(*order); });
     }
 
     // Initialize level (for starting from a snapshot)
     void addLevel(Price price, Quantity size, Side side) {
-        Limit* limit = getOrCreateLimit(price, side);
+        BestWatch watch(*this);
+        Limit* limit = findOrCreateLimit(price, side);
         limit->totalVolume += size;
+        syncLevel(side, limit);
         // checking orderCount is 0, so head/tail are nullptr.
         // This effectively creates "Dark Matter" volume that we track but can't name.
     }
@@ -83,16 +117,18 @@ public:
     // Cancel an order by ID
     // Returns true if found and canceled
     bool cancelOrder(OrderID id) {
-        auto it = orderLookup_.find(id);
-        if (it != orderLookup_.end()) {
-            Order* order = it->second;
+        BestWatch watch(*this);
+        Order* order = orderLookup_.find(id);
+        if (order != nullptr) {
             Limit* limit = order->parentLimit;
             limit->removeOrder(order);
+            syncLevel(order->side, limit);
+            notify([&](auto& l) { l.onOrderRemoved(*order); });
             if (limit->isEmpty() && limit->totalVolume == 0) {
                 removeLimit(limit);
             }
             orderAllocator_.deallocate(order);
-            orderLookup_.erase(it);
+            orderLookup_.erase(id);
             return true;
         }
         return false;
@@ -101,24 +137,27 @@ public:
     // Overloaded for convenience/backward compat if needed, but we should change the main interface
     // LOBSTER Type 3 (Delete) has: Timestamp, Type, ID, Size, Price, Direction.
     void deleteOrder(OrderID id, Price price, Quantity size, Side side) {
-        auto it = orderLookup_.find(id);
-        if (it != orderLookup_.end()) {
+        BestWatch watch(*this);
+        Order* order = orderLookup_.find(id);
+        if (order != nullptr) {
             // We found the order, just remove it standard way. 
             // We assume the size matches what we have or we just trust the ID removal.
-            Order* order = it->second;
             Limit* limit = order->parentLimit;
             limit->removeOrder(order);
+            syncLevel(order->side, limit);
+            notify([&](auto& l) { l.onOrderRemoved(*order); });
              if (limit->isEmpty() && limit->totalVolume == 0) {
                  removeLimit(limit);
              }
              orderAllocator_.deallocate(order);
-             orderLookup_.erase(it);
+             orderLookup_.erase(id);
         } else {
             // Fallback
              Limit* limit = getLimit(price, side);
              if (limit) {
                  if (size > limit->totalVolume) limit->totalVolume = 0; // Safety clamp
                  else limit->totalVolume -= size;
+                 syncLevel(side, limit);
                  
                  // If volume hits 0 (and no orders), remove limit
                  if (limit->totalVolume == 0 && limit->orderCount == 0) {
@@ -130,21 +169,25 @@ public:
 
     // Partial Cancel (Type 2)
     void reduceOrder(OrderID id, Quantity reductionSize, Price price, Side side) {
-        auto it = orderLookup_.find(id);
-        if (it != orderLookup_.end()) {
-            Order* order = it->second;
+        BestWatch watch(*this);
+        Order* order = orderLookup_.find(id);
+        if (order != nullptr) {
             if (reductionSize >= order->size) {
                  // Convert to delete
                  // Re-find to avoid iterator issues or just call logic directly
                  // We call internal remove
                  Limit* limit = order->parentLimit;
                  limit->removeOrder(order);
+                 syncLevel(order->side, limit);
+                 notify([&](auto& l) { l.onOrderRemoved(*order); });
                  if (limit->isEmpty() && limit->totalVolume == 0) removeLimit(limit);
                  orderAllocator_.deallocate(order);
-                 orderLookup_.erase(it);
+                 orderLookup_.erase(id);
             } else {
                 order->size -= reductionSize;
                 order->parentLimit->totalVolume -= reductionSize;
+                syncLevel(order->side, order->parentLimit);
+                notify([&](auto& l) { l.onOrderReduced(*order, reductionSize); });
             }
         } else {
             // Fallback
@@ -152,6 +195,7 @@ public:
             if (limit) {
                  if (reductionSize > limit->totalVolume) limit->totalVolume = 0;
                  else limit->totalVolume -= reductionSize;
+                 syncLevel(side, limit);
                   if (limit->totalVolume == 0 && limit->orderCount == 0) removeLimit(limit);
             }
         }
@@ -162,6 +206,65 @@ public:
         reduceOrder(id, executedSize, price, side);
     }
 
+    // Apply one LOBSTER message (types 1-4; hidden executions and halts don't touch the book)
+    void apply(const RAWMessage& msg) {
+        // Pass Price/Side/Size for fallback handling
+        Side side = (msg.direction == 1 ? Side::Buy : Side::Sell);
+
+        switch (msg.type) {
+            case 1: // Add
+                addOrder(msg.orderId, msg.price, msg.size, side,
+                         static_cast<uint64_t>(msg.timestamp * 1e9));
+                break;
+            case 2: // Partial Cancel
+                reduceOrder(msg.orderId, msg.size, msg.price, side);
+                break;
+            case 3: // Delete
+                deleteOrder(msg.orderId, msg.price, msg.size, side);
+                break;
+            case 4: // Execution
+                executeOrder(msg.orderId, msg.size, msg.price, side);
+                break;
+            case 5: // Hidden Exec - Ignore
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Apply a batch of messages in order, with exactly the same result as calling apply() on each.
+    //
+    // Cancels/executions each take a chain of dependent misses (index slot -> Order -> Limit).
+    // The batch is software-pipelined so those misses overlap across messages:
+    //   message i + kPrefetchSlot:  prefetch its index slot
+    //   message i + kPrefetchOrder: look up (slot now cached) and prefetch the Order and its slab block header
+    //   message i + kPrefetchLimit: read order->parentLimit (Order now cached) and prefetch the Limit
+    //   message i:                  apply
+    // Lookaheads only prefetch; if an earlier message in the batch removes or adds the order,
+    // the hint is merely wasted. The only dereference (order->parentLimit) is of an Order that
+    // find() has just returned, so it is live at that moment even though the BlockPool may
+    // free slab blocks; every other lookahead just hands an address to the prefetcher.
+    void applyBatch(std::span<const RAWMessage> messages) {
+        const size_t n = messages.size();
+        for (size_t i = 0; i < n; ++i) {
+            if (i + kPrefetchSlot < n) {
+                orderLookup_.prefetch(messages[i + kPrefetchSlot].orderId);
+            }
+            if (i + kPrefetchOrder < n && messages[i + kPrefetchOrder].type != 1) {
+                if (const Order* order = orderLookup_.find(messages[i + kPrefetchOrder].orderId)) {
+                    prefetchWrite(order);
+                    prefetchWrite(SlabAllocator<Order>::blockOf(order));
+                }
+            }
+            if (i + kPrefetchLimit < n && messages[i + kPrefetchLimit].type != 1) {
+                if (const Order* order = orderLookup_.find(messages[i + kPrefetchLimit].orderId)) {
+                    prefetchWrite(order->parentLimit);
+                }
+            }
+            apply(messages[i]);
+        }
+    }
+
     // Get Best Bid/Ask
     Price getBestBid() const {
         if (bids_.empty()) return INVALID_PRICE;
@@ -199,6 +302,16 @@ public:
         return 0;
     }
 
+    // Volume resting at `price` on one side (a locked or crossed price can be on both)
+    Quantity getVolumeAtPrice(Price price, Side side) const {
+        if (side == Side::Buy) {
+            auto it = bids_.find(price);
+            return it != bids_.end() ? it->second->totalVolume : 0;
+        }
+        auto it = asks_.find(price);
+        return it != asks_.end() ? it->second->totalVolume : 0;
+    }
+
     // Quant Features
     
     // Order Book Imbalance (OBI) = (BestBidSize - BestAskSize) / (BestBidSize + BestAskSize)
@@ -232,26 +345,244 @@ public:
         return (static_cast<double>(bid * askSize) + static_cast<double>(ask * bidSize)) / static_cast<double>(bidSize + askSize);
     }
 
+    // Best bid/ask with their volumes in one call
+    TopOfBook getTopOfBook() const {
+        TopOfBook top;
+        if (!bids_.empty()) {
+            auto it = bids_.begin();
+            top.bidPrice = it->first;
+            top.bidSize = it->second->totalVolume;
+        }
+        if (!asks_.empty()) {
+            auto it = asks_.begin();
+            top.askPrice = it->first;
+            top.askSize = it->second->totalVolume;
+        }
+        return top;
+    }
+
+    // Copy up to maxLevels levels of one side into out, best first.
+    // Returns the number of levels written.
+    size_t getDepth(Side side, PriceLevel* out, size_t maxLevels) const {
+        const DepthLadder& ladder = getLadder(side);
+        size_t n = std::min(maxLevels, ladder.size());
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = {ladder.priceAt(i), ladder.volumeAt(i)};
+        }
+        return n;
+    }
+
+    // --- Depth / Market Impact Queries ---
+    // Served from the contiguous per-side ladders, not the maps.
+
+    // Walk `bookSide` from the touch for `size` (e.g. Side::Sell = cost of a buy sweep)
+    SweepEstimate estimateSweep(Side bookSide, Quantity size) const {
+        const DepthLadder& ladder = getLadder(bookSide);
+        SweepEstimate est;
+        size_t full = ladder.scanFullLevels(size, est.filled, est.notional);
+        est.levels = full;
+        if (full < ladder.size()) {
+            Quantity remaining = size - est.filled;
+            Price price = ladder.priceAt(full);
+            est.filled = size;
+            est.notional += price * static_cast<int64_t>(remaining);
+            est.lastPrice = price;
+            est.levels = full + 1;
+        } else if (full > 0) {
+            est.lastPrice = ladder.priceAt(full - 1);
+        }
+        return est;
+    }
+
+    // VWAP of sweeping `size` from `bookSide` (0 if that side is empty)
+    double getSweepVWAP(Side bookSide, Quantity size) const {
+        return estimateSweep(bookSide, size).vwap();
+    }
+
+    // Total volume on `side` priced at or better than limitPrice
+    Quantity getCumulativeDepth(Side side, Price limitPrice) const {
+        const DepthLadder& ladder = getLadder(side);
+        return ladder.sumVolume(ladder.levelsWithin(limitPrice));
+    }
+
+    // Total volume on `side` within `distance` price units of the mid (0 if one-sided)
+    Quantity getDepthNearMid(Side side, Price distance) const {
+        if (bidLadder_.empty() || askLadder_.empty()) return 0;
+        double mid = (static_cast<double>(bidLadder_.priceAt(0)) + static_cast<double>(askLadder_.priceAt(0))) / 2.0;
+        Price limitPrice = side == Side::Buy
+            ? static_cast<Price>(std::ceil(mid - static_cast<double>(distance)))
+            : static_cast<Price>(std::floor(mid + static_cast<double>(distance)));
+        return getCumulativeDepth(side, limitPrice);
+    }
+
+    // Price of the level at which cumulative volume from the touch reaches `cumulativeSize`
+    // Returns INVALID_PRICE if the side does not hold that much.
+    Price getPriceForSize(Side side, Quantity cumulativeSize) const {
+        const DepthLadder& ladder = getLadder(side);
+        Quantity consumed;
+        int64_t notional;
+        size_t full = ladder.scanFullLevels(cumulativeSize, consumed, notional);
+        return full < ladder.size() ? ladder.priceAt(full) : INVALID_PRICE;
+    }
+
+    const DepthLadder& getLadder(Side side) const {
+        return side == Side::Buy ? bidLadder_ : askLadder_;
+    }
+
+    // Empty the book for reuse (e.g. the next file in a batch): keeps the order
+    // slab, index table and ladder capacity, so no large allocations are repeated.
+    void reset() {
+        for (auto& pair : bids_) {
+            delete pair.second;
+        }
+        for (auto& pair : asks_) {
+            delete pair.second;
+        }
+        bids_.clear();
+        asks_.clear();
+        bidLadder_.clear();
+        askLadder_.clear();
+        orderLookup_.clear();
+        orderAllocator_.reset();
+    }
+
     // Diagnostics/Verification helper
     size_t getOrderCount() const { return orderLookup_.size(); }
 
+    BookMemory memoryUsage() const {
+        // std::map node: three pointers, colour, key and value
+        constexpr size_t kMapNodeBytes = 3 * sizeof(void*) + sizeof(void*) + sizeof(Price) + sizeof(Limit*);
+        BookMemory mem;
+        mem.orderSlab = orderAllocator_.memoryUsage();
+        mem.orderIndex = orderLookup_.memoryUsage();
+        mem.levels = (bids_.size() + asks_.size()) * (sizeof(Limit) + kMapNodeBytes);
+        mem.ladders = bidLadder_.memoryUsage() + askLadder_.memoryUsage();
+        return mem;
+    }
+
 private:
+    // Only listeners that shadow onBestPriceChanged / onTopOfBookChanged pay for tracking the touch
+    template <typename L>
+    static constexpr bool kWatchesBest =
+        !std::is_same_v<decltype(&L::onBestPriceChanged), decltype(&BookListener::onBestPriceChanged)>;
+    template <typename L>
+    static constexpr bool kWatchesTop =
+        !std::is_same_v<decltype(&L::onTopOfBookChanged), decltype(&BookListener::onTopOfBookChanged)>;
+    static constexpr bool kWatchBest = (kWatchesBest<Listeners> || ...);
+    static constexpr bool kWatchTop = (kWatchesTop<Listeners> || ...);
+    static constexpr bool kWatchCalls = kWatchBest || kWatchTop;
+
+    struct NoDepth {};
+
+    [[no_unique_address]] std::tuple<Listeners...> listeners_;
+    // Nesting of public mutators, so touch changes are reported once per call
+    [[no_unique_address]] std::conditional_t<kWatchCalls, int, NoDepth> mutationDepth_{};
+
+    template <typename F>
+    void notify(F&& callback) {
+        std::apply([&](auto&... l) { (callback(l), ...); }, listeners_);
+    }
+
+    // Brackets a public mutator: remembers the touch on entry to the outermost
+    // one and reports the sides whose best price moved, then the new top of
+    // book if it moved at all, when it returns. Sizes are only read when a
+    // listener wants onTopOfBookChanged. Without a listener for either, it is
+    // empty and compiles away.
+    class BestWatch {
+    public:
+        explicit BestWatch(BasicOrderBook& book) : book_(book) {
+            if constexpr (kWatchCalls) {
+                if (book_.mutationDepth_++ == 0) top_ = current();
+            }
+        }
+
+        ~BestWatch() {
+            if constexpr (kWatchCalls) {
+                if (--book_.mutationDepth_ != 0) return;
+                const TopOfBook top = current();
+                if constexpr (kWatchBest) {
+                    if (top.bidPrice != top_.bidPrice) book_.notify([&](auto& l) { l.onBestPriceChanged(Side::Buy, top.bidPrice); });
+                    if (top.askPrice != top_.askPrice) book_.notify([&](auto& l) { l.onBestPriceChanged(Side::Sell, top.askPrice); });
+                }
+                if constexpr (kWatchTop) {
+                    if (top != top_) book_.notify([&](auto& l) { l.onTopOfBookChanged(top); });
+                }
+            }
+        }
+
+        BestWatch(const BestWatch&) = delete;
+        BestWatch& operator=(const BestWatch&) = delete;
+
+    private:
+        BasicOrderBook& book_;
+        TopOfBook top_;
+
+        TopOfBook current() const {
+            if constexpr (kWatchTop) return book_.getTopOfBook();
+            TopOfBook top;
+            top.bidPrice = book_.getBestBid();
+            top.askPrice = book_.getBestAsk();
+            return top;
+        }
+    };
+
     // Buy side: High prices first (descending)
     std::map<Price, Limit*, std::greater<Price>> bids_;
     // Sell side: Low prices first (ascending)
     std::map<Price, Limit*, std::less<Price>> asks_;
     
     // O(1) Order Lookup
-    std::unordered_map<OrderID, Order*> orderLookup_;
+    OrderIndex orderLookup_;
+
+    // Batch pipeline lookahead distances (messages ahead of the one being applied)
+    static constexpr size_t kPrefetchSlot = 12;
+    static constexpr size_t kPrefetchOrder = 8;
+    static constexpr size_t kPrefetchLimit = 4;
 
     // Memory Pool
     SlabAllocator<Order> orderAllocator_;
 
+    // Contiguous mirrors of bids_/asks_ for vectorized depth scans
+    DepthLadder bidLadder_;
+    DepthLadder askLadder_;
+
+    static size_t ladderReserve(size_t expectedOrders) {
+        return std::min<size_t>(1024, std::max<size_t>(16, expectedOrders / 4));
+    }
+
+    Limit* findOrCreateLimit(Price price, Side side) {
+        if (side == Side::Buy) {
+            auto it = bids_.find(price);
+            if (it != bids_.end()) return it->second;
+            
+            Limit* limit = new Limit(price); 
+            bids_[price] = limit;
+            bidLadder_.setVolume(price, 0);
+            notify([&](auto& l) { l.onLevelCreated(side, price); });
+            return limit;
+        } else {
+            auto it = asks_.find(price);
+            if (it != asks_.end()) return it->second;
+            
+            Limit* limit = new Limit(price);
+            asks_[price] = limit;
+            askLadder_.setVolume(price, 0);
+            notify([&](auto& l) { l.onLevelCreated(side, price); });
+            return limit;
+        }
+    }
+
+    void syncLevel(Side side, const Limit* limit) {
+        (side == Side::Buy ? bidLadder_ : askLadder_).setVolume(limit->limitPrice, limit->totalVolume);
+    }
+
     void removeLimit(Limit* limit) {
         if (limit->totalVolume > 0) return; // Safety check
         auto bidIt = bids_.find(limit->limitPrice);
         if (bidIt != bids_.end() && bidIt->second == limit) {
             bids_.erase(bidIt);
+            bidLadder_.erase(limit->limitPrice);
+            notify([&](auto& l) { l.onLevelRemoved(Side::Buy, limit->limitPrice); });
             delete limit;
             return;
         }
@@ -259,10 +590,14 @@ private:
         auto askIt = asks_.find(limit->limitPrice);
         if (askIt != asks_.end() && askIt->second == limit) {
             asks_.erase(askIt);
+            askLadder_.erase(limit->limitPrice);
+            notify([&](auto& l) { l.onLevelRemoved(Side::Sell, limit->limitPrice); });
             delete limit;
             return;
         }
     }
 };
 
+using OrderBook = BasicOrderBook<>;
+
 }
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "LOB/Types.h"
+#include "LOB/Order.h"
+
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#endif
+
+namespace LOB {
+
+// Hint the CPU to pull a cache line in ahead of use. Never faults, even on stale addresses.
+inline void prefetchRead(const void* address) {
+#if defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    __builtin_prefetch(address, 0, 3);
+#endif
+}
+
+inline void prefetchWrite(const void* address) {
+#if defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    __builtin_prefetch(address, 1, 3);
+#endif
+}
+
+// OrderID -> Order* hash index (open addressing, linear probing).
+//
+// Replaces std::unordered_map for the O(1) lookup: one flat array of 16-byte
+// slots instead of a bucket array plus a heap node per order, and, unlike
+// unordered_map, the slot an ID hashes to is computable up front, so batched
+// processing can prefetch it several messages ahead.
+//
+// Key 0 (INVALID_ORDER_ID) marks an empty slot; an order that really has ID 0
+// is kept in a side slot. Deletion uses backward shifting, so there are no
+// tombstones and probe chains stay short.
+//
+// The table doubles above 3/4 load and halves below 1/4, but never below the
+// size for expectedOrders, so it follows a burst back down.
+class OrderIndex {
+public:
+    explicit OrderIndex(size_t expectedOrders = 1024) : minCapacity_(capacityFor(expectedOrders)) {
+        rehash(minCapacity_);
+    }
+
+    size_t size() const { return size_ + (zeroOrder_ ? 1 : 0); }
+
+    Order* find(OrderID id) const {
+        if (id == INVALID_ORDER_ID) return zeroOrder_;
+        for (size_t i = home(id);; i = (i + 1) & mask_) {
+            const Slot& slot = slots_[i];
+            if (slot.key == id) return slot.order;
+            if (slot.key == INVALID_ORDER_ID) return nullptr;
+        }
+    }
+
+    // Caller guarantees `id` is not present
+    void insert(OrderID id, Order* order) {
+        if (id == INVALID_ORDER_ID) {
+            zeroOrder_ = order;
+            return;
+        }
+        if ((size_ + 1) * 4 > slots_.size() * 3) rehash(slots_.size() * 2);
+        place(id, order);
+        ++size_;
+    }
+
+    void erase(OrderID id) {
+        if (id == INVALID_ORDER_ID) {
+            zeroOrder_ = nullptr;
+            return;
+        }
+        size_t i = home(id);
+        while (slots_[i].key != id) {
+            if (slots_[i].key == INVALID_ORDER_ID) return;
+            i = (i + 1) & mask_;
+        }
+        // Backward-shift the rest of the cluster into the hole
+        for (size_t j = (i + 1) & mask_;; j = (j + 1) & mask_) {
+            if (slots_[j].key == INVALID_ORDER_ID) break;
+            size_t h = home(slots_[j].key);
+            // Move slot j back if its home is not in (i, j]
+            if (((j - h) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i] = Slot{};
+        --size_;
+        if (size_ * 4 < slots_.size() && slots_.size() > minCapacity_) rehash(slots_.size() / 2);
+    }
+
+    // Empty, and back to the size for expectedOrders
+    void clear() {
+        size_ = 0;
+        zeroOrder_ = nullptr;
+        if (slots_.size() > minCapacity_) {
+            std::vector<Slot>().swap(slots_);
+            rehash(minCapacity_);
+            return;
+        }
+        for (Slot& slot : slots_) slot = Slot{};
+    }
+
+    // Prefetch the slot `id` hashes to (batched processing, stage 1)
+    void prefetch(OrderID id) const { prefetchRead(&slots_[home(id)]); }
+
+    // Bytes held by the slot array
+    size_t memoryUsage() const { return slots_.capacity() * sizeof(Slot); }
+
+private:
+    struct Slot {
+        OrderID key = INVALID_ORDER_ID;
+        Order* order = nullptr;
+    };
+
+    std::vector<Slot> slots_;
+    size_t minCapacity_;
+    size_t mask_ = 0;
+    unsigned shift_ = 0;
+    size_t size_ = 0;
+    Order* zeroOrder_ = nullptr;
+
+    static size_t capacityFor(size_t expectedOrders) {
+        // Keep load <= 3/4
+        return std::bit_ceil(std::max<size_t>(16, expectedOrders + expectedOrders / 3 + 1));
+    }
+
+    // Fibonacci hashing: sequential exchange IDs spread evenly
+    size_t home(OrderID id) const {
+        return static_cast<size_t>((id * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    void place(OrderID id, Order* order) {
+        size_t i = home(id);
+        while (slots_[i].key != INVALID_ORDER_ID) i = (i + 1) & mask_;
+        slots_[i] = Slot{id, order};
+    }
+
+    void rehash(size_t capacity) {
+        std::vector<Slot> old;
+        old.swap(slots_);
+        slots_.assign(capacity, Slot{});
+        mask_ = capacity - 1;
+        shift_ = 64u - static_cast<unsigned>(std::countr_zero(capacity));
+        for (const Slot& slot : old) {
+            if (slot.key != INVALID_ORDER_ID) place(slot.key, slot.order);
+        }
+    }
+};
+
+}
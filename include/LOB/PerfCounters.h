@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace LOB {
+
+enum class PerfEvent : uint8_t {
+    Cycles,
+    Instructions,
+    L1DMisses,
+    LLCMisses,
+    DTLBMisses,
+    BranchMisses
+};
+
+constexpr size_t kPerfEventCount = 6;
+
+inline const char* perfEventName(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles:       return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::L1DMisses:    return "L1D_misses";
+        case PerfEvent::LLCMisses:    return "LLC_misses";
+        case PerfEvent::DTLBMisses:   return "dTLB_misses";
+        case PerfEvent::BranchMisses: return "branch_misses";
+    }
+    return "unknown";
+}
+
+// Counter values; only the events reported by PerfCounters::available() are meaningful.
+//
+// values are raw counts. When the PMU is shared with other users the kernel
+// time-slices the counter group, which then only counts for timeRunning of
+// the timeEnabled nanoseconds; scaled() extrapolates to the whole interval.
+struct PerfSample {
+    std::array<uint64_t, kPerfEventCount> values{};
+    uint64_t timeEnabled = 0;
+    uint64_t timeRunning = 0;
+
+    uint64_t operator[](PerfEvent event) const { return values[static_cast<size_t>(event)]; }
+
+    // The group was off the PMU for part of the interval
+    bool multiplexed() const { return timeRunning < timeEnabled; }
+
+    double scaled(PerfEvent event) const {
+        const double raw = static_cast<double>((*this)[event]);
+        if (!multiplexed()) return raw;
+        return timeRunning > 0 ? raw * static_cast<double>(timeEnabled) / static_cast<double>(timeRunning) : 0.0;
+    }
+
+    PerfSample operator-(const PerfSample& other) const {
+        PerfSample diff;
+        for (size_t i = 0; i < kPerfEventCount; ++i) diff.values[i] = values[i] - other.values[i];
+        diff.timeEnabled = timeEnabled - other.timeEnabled;
+        diff.timeRunning = timeRunning - other.timeRunning;
+        return diff;
+    }
+
+    PerfSample& operator+=(const PerfSample& other) {
+        for (size_t i = 0; i < kPerfEventCount; ++i) values[i] += other.values[i];
+        timeEnabled += other.timeEnabled;
+        timeRunning += other.timeRunning;
+        return *this;
+    }
+};
+
+// User-space hardware counters for the calling thread, via perf_event_open.
+//
+// The events are opened as one group, led by the first that opens, so the
+// kernel puts them on the PMU together and their ratios are comparable. One
+// that fails to open or does not fit beside the others (no PMU in a VM, an
+// event the CPU lacks, perf_event_paranoid too strict, non-Linux build) is
+// left out without disabling the rest. When nothing opens, available() is
+// false, read() returns zeros and the callers simply skip reporting.
+//
+// read() uses rdpmc through the perf mmap pages when the kernel allows it
+// (tens of cycles, cheap enough to bracket single messages). While the group
+// is off the PMU, or without rdpmc, it falls back to one read() of the whole
+// group. Either way the sample carries time enabled / running (see PerfSample).
+class PerfCounters {
+public:
+    PerfCounters() {
+#if defined(__linux__)
+        static constexpr struct { uint32_t type; uint64_t config; } kEvents[kPerfEventCount] = {
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        };
+
+        for (size_t i = 0; i < kPerfEventCount; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = kEvents[i].type;
+            attr.config = kEvents[i].config;
+            attr.disabled = leader_ < 0 ? 1 : 0; // members follow the leader
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            if (fd < 0) {
+                if (error_.empty()) error_ = std::string(perfEventName(static_cast<PerfEvent>(i))) + ": " + std::strerror(errno);
+                continue;
+            }
+            fds_[i] = fd;
+            if (leader_ < 0) leader_ = fd;
+            groupOrder_[groupSize_++] = i;
+
+            void* page = mmap(nullptr, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_READ, MAP_SHARED, fd, 0);
+            if (page != MAP_FAILED) pages_[i] = static_cast<perf_event_mmap_page*>(page);
+        }
+#else
+        error_ = "perf_event_open is Linux-only";
+#endif
+    }
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (size_t i = 0; i < kPerfEventCount; ++i) {
+            if (pages_[i]) munmap(pages_[i], static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+            if (fds_[i] >= 0) close(fds_[i]);
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    bool available() const {
+        for (int fd : fds_) {
+            if (fd >= 0) return true;
+        }
+        return false;
+    }
+
+    bool available(PerfEvent event) const { return fds_[static_cast<size_t>(event)] >= 0; }
+
+    // Why the first unavailable event failed to open (empty if all opened)
+    const std::string& error() const { return error_; }
+
+    // Zero and enable / disable the whole group
+    void start() {
+#if defined(__linux__)
+        if (leader_ < 0) return;
+        ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    void stop() {
+#if defined(__linux__)
+        if (leader_ >= 0) ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+    }
+
+    PerfSample read() const {
+        PerfSample sample;
+#if defined(__linux__)
+        if (leader_ < 0) return sample;
+        bool mapped = true;
+        for (size_t k = 0; k < groupSize_ && mapped; ++k) {
+            const size_t i = groupOrder_[k];
+            uint64_t enabled = 0, running = 0;
+            mapped = readMapped(i, sample.values[i], enabled, running);
+            if (k == 0) {
+                // Group members share one schedule: the leader's times stand for all
+                sample.timeEnabled = enabled;
+                sample.timeRunning = running;
+            }
+        }
+        if (mapped) return sample;
+
+        // PERF_FORMAT_GROUP layout: nr, time_enabled, time_running, then one value per member in open order
+        std::array<uint64_t, 3 + kPerfEventCount> group{};
+        sample = PerfSample{};
+        if (::read(leader_, group.data(), sizeof(group)) >= static_cast<ssize_t>(3 * sizeof(uint64_t))) {
+            sample.timeEnabled = group[1];
+            sample.timeRunning = group[2];
+            for (size_t k = 0; k < groupSize_ && k < group[0]; ++k) sample.values[groupOrder_[k]] = group[3 + k];
+        }
+#endif
+        return sample;
+    }
+
+private:
+    std::array<int, kPerfEventCount> fds_ = {-1, -1, -1, -1, -1, -1};
+    std::string error_;
+#if defined(__linux__)
+    int leader_ = -1;
+    std::array<size_t, kPerfEventCount> groupOrder_{}; // event of each group member, in open order
+    size_t groupSize_ = 0;
+    std::array<perf_event_mmap_page*, kPerfEventCount> pages_{};
+
+    // Self-monitoring read (see perf_event_open(2), "mmap layout"). Fails
+    // while the event is off the PMU (index 0): offset alone would miss what
+    // the hardware counter holds.
+    bool readMapped(size_t i, uint64_t& value, uint64_t& enabled, uint64_t& running) const {
+#if defined(__x86_64__) || defined(__i386__)
+        volatile perf_event_mmap_page* pc = pages_[i];
+        if (!pc) return false;
+        uint32_t seq;
+        int64_t count;
+        uint64_t timeEnabled, timeRunning;
+        do {
+            seq = pc->lock;
+            __atomic_signal_fence(__ATOMIC_SEQ_CST);
+            if (!pc->cap_user_rdpmc) return false;
+            const uint32_t idx = pc->index;
+            if (idx == 0) return false;
+            timeEnabled = pc->time_enabled;
+            timeRunning = pc->time_running;
+            if (pc->cap_user_time) {
+                // Time since the kernel last updated the page; the event has been running throughout
+                const uint64_t cycles = __builtin_ia32_rdtsc();
+                const uint16_t shift = pc->time_shift;
+                const uint32_t mult = pc->time_mult;
+                const uint64_t quot = cycles >> shift;
+                const uint64_t rem = cycles & ((uint64_t(1) << shift) - 1);
+                const uint64_t delta = pc->time_offset + quot * mult + ((rem * mult) >> shift);
+                timeEnabled += delta;
+                timeRunning += delta;
+            }
+            count = pc->offset;
+            uint32_t lo, hi;
+            __asm__ volatile("rdpmc" : "=a"(lo), "=d"(hi) : "c"(idx - 1));
+            int64_t pmc = static_cast<int64_t>((static_cast<uint64_t>(hi) << 32) | lo);
+            const unsigned shift = 64 - pc->pmc_width;
+            pmc = static_cast<int64_t>(static_cast<uint64_t>(pmc) << shift) >> shift;
+            count += pmc;
+            __atomic_signal_fence(__ATOMIC_SEQ_CST);
+        } while (pc->lock != seq);
+        value = static_cast<uint64_t>(count);
+        enabled = timeEnabled;
+        running = timeRunning;
+        return true;
+#else
+        (void)i;
+        (void)value;
+        (void)enabled;
+        (void)running;
+        return false;
+#endif
+    }
+#endif
+};
+
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/CSVParser.h"
+#include "LOB/InputSource.h"
+
+namespace LOB {
+
+// One level of a LOBSTER orderbook-file row
+struct TruthLevel {
+    Price askPrice;
+    Quantity askSize;
+    Price bidPrice;
+    Quantity bidSize;
+};
+
+// LOBSTER pads missing levels with this price
+constexpr Price kLobsterEmptyPrice = -9999999999;
+
+// Parses one orderbook-file row (up to 10 levels) and advances `current` past it
+inline std::vector<TruthLevel> parseTruthLine(const char*& current, const char* end) {
+    std::vector<TruthLevel> levels;
+    levels.reserve(10);
+
+    for (int i = 0; i < 10; ++i) {
+        if (current >= end) break;
+        TruthLevel lvl;
+
+        char* nextToken;
+        // Ask Price
+        lvl.askPrice = std::strtoll(current, &nextToken, 10);
+        current = nextToken + 1;
+        // Ask Size
+        lvl.askSize = std::strtoull(current, &nextToken, 10);
+        current = nextToken + 1;
+        // Bid Price
+        lvl.bidPrice = std::strtoll(current, &nextToken, 10);
+        current = nextToken + 1;
+        // Bid Size
+        lvl.bidSize = std::strtoull(current, &nextToken, 10);
+        current = nextToken + 1; // Skip comma or newline
+
+        levels.push_back(lvl);
+    }
+    // Skip newline
+    if (current < end && (*current == '\n' || *current == '\r')) current++;
+    if (current < end && *current == '\n') current++; // Handle CRLF
+
+    return levels;
+}
+
+struct ReplayStats {
+    uint64_t messages = 0;   // including the skipped first message
+    uint64_t mismatches = 0; // non-empty levels whose volume disagreed with the truth file (all of them, not just the logged ones)
+    uint64_t heals = 0;      // levels corrected (mismatches plus levels we were missing)
+    double seconds = 0.0;
+};
+
+// Per-message hooks for replayVerified. Derive and shadow what you need;
+// calls are resolved statically, so the defaults cost nothing.
+struct ReplayHooks {
+    void beforeApply(const RAWMessage&) {}
+    void afterApply(const RAWMessage&) {}
+    // After the book has been verified/healed against the truth row
+    template <typename Book>
+    void afterMessage(const RAWMessage&, const Book&, uint64_t /*messageNumber*/) {}
+};
+
+// Replay a LOBSTER message file into `book` (which should be empty), checking
+// the best bid/ask after every message against the matching orderbook-file row.
+//
+// The book is seeded from the first truth row and message 1 is skipped (it is
+// already reflected there). Because the snapshot only covers the top levels,
+// messages can touch volume we never saw; any disagreement at the touch is
+// "healed" by adding/executing a correction so later messages keep applying.
+// The first `maxLogged` mismatches are written to `log` (if given).
+template <typename Hooks = ReplayHooks, typename... Listeners>
+ReplayStats replayVerified(BasicOrderBook<Listeners...>& book, const std::string& messagePath, const std::string& orderbookPath,
+                           Hooks&& hooks = Hooks{}, std::ostream* log = nullptr, uint64_t maxLogged = 10) {
+    ReplayStats stats;
+    auto timeStart = std::chrono::steady_clock::now();
+
+    LobsterMessageParser msgParser(messagePath);
+    // Compressed inputs arrive in chunks of whole lines; fetch the next one when the current is used up
+    auto truthSource = openInput(orderbookPath);
+    const char* truthCurrent = nullptr;
+    const char* truthEnd = nullptr;
+    auto nextTruthLine = [&]() {
+        while (truthCurrent >= truthEnd) {
+            if (!truthSource->nextChunk(truthCurrent, truthEnd)) return std::vector<TruthLevel>{};
+        }
+        return parseTruthLine(truthCurrent, truthEnd);
+    };
+
+    // --- Initialization Phase ---
+    // Initialize with Truth Line 1, then SKIP Msg 1. Start verifying from Msg 2.
+    auto truthLevelsInit = nextTruthLine();
+    if (truthLevelsInit.empty()) {
+        throw std::runtime_error("Empty truth file: " + orderbookPath);
+    }
+    for (const auto& level : truthLevelsInit) {
+        if (level.askPrice != kLobsterEmptyPrice)
+            book.addLevel(level.askPrice, level.askSize, Side::Sell);
+        if (level.bidPrice != kLobsterEmptyPrice)
+            book.addLevel(level.bidPrice, level.bidSize, Side::Buy);
+    }
+
+    RAWMessage msg;
+    if (!msgParser.next(msg)) {
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+        return stats;
+    }
+    stats.messages++; // Count it as processed (or skipped)
+
+    // Correction orders get IDs far above LOBSTER's
+    uint64_t dummyId = 9000000000ULL;
+
+    // Inject a real order (or execute volume away) so the level matches the truth
+    // and later executions have something to hit.
+    auto healLevel = [&](Price tPrice, Quantity tSize, Side side) {
+        Limit* limit = book.getOrCreateLimit(tPrice, side);
+        if (limit->totalVolume == tSize) return;
+        stats.heals++;
+        if (limit->totalVolume == 0) {
+            // Missing level
+            book.addOrder(++dummyId, tPrice, tSize, side, 0);
+        } else {
+            // Volume mismatch: we can't tell which order is off, so add or
+            // execute a correction for the difference.
+            int64_t diff = (int64_t)tSize - (int64_t)limit->totalVolume;
+            ++dummyId;
+            if (diff > 0) {
+                book.addOrder(dummyId, tPrice, (uint64_t)diff, side, 0);
+            } else {
+                book.executeOrder(0, (uint64_t)(-diff), tPrice, side);
+            }
+        }
+    };
+
+    auto checkLevel = [&](Price tPrice, Quantity tSize, Side side) {
+        if (tPrice == kLobsterEmptyPrice) return;
+        Quantity myVol = book.getVolumeAtPrice(tPrice);
+        if (myVol == tSize) return;
+        if (myVol != 0) {
+            if (log && stats.mismatches < maxLogged) {
+                *log << "Mismatch at msg " << stats.messages << " (" << (side == Side::Sell ? "ASK " : "BID ") << tPrice << "): "
+                     << "Exp " << tSize << ", Got " << myVol << std::endl;
+            }
+            stats.mismatches++;
+        }
+        // Always Heal
+        healLevel(tPrice, tSize, side);
+    };
+
+    // --- Simulation Phase ---
+    while (msgParser.next(msg)) {
+        stats.messages++;
+
+        hooks.beforeApply(msg);
+        book.apply(msg);
+        hooks.afterApply(msg);
+
+        // Verification
+        // We consumed Msg N. We need Truth N.
+        auto truthLevels = nextTruthLine();
+        if (!truthLevels.empty()) {
+            const TruthLevel& truth = truthLevels[0];
+            checkLevel(truth.askPrice, truth.askSize, Side::Sell);
+            checkLevel(truth.bidPrice, truth.bidSize, Side::Buy);
+        }
+
+        hooks.afterMessage(msg, book, stats.messages);
+    }
+
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - timeStart).count();
+    return stats;
+}
+
+}
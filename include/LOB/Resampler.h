@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "LOB/Types.h"
+#include "LOB/BookSnapshot.h"
+#include "LOB/CSVParser.h"
+#include "LOB/ColumnarWriter.h"
+
+namespace LOB {
+
+// One closed time bucket
+struct Bar {
+    double startTime;        // seconds after midnight, bucket start
+    // Book state at bucket close
+    Price bidPrice;
+    Quantity bidSize;
+    Price askPrice;
+    Quantity askSize;
+    // Executions (LOBSTER types 4 and 5); prices are INVALID_PRICE when tradeCount == 0
+    Price open;
+    Price high;
+    Price low;
+    Price close;
+    Quantity volume;
+    double vwap;
+    uint32_t tradeCount;
+    uint32_t eventCount;
+    // Mean of (ask - bid) sampled after every event in the bucket (carried over when empty)
+    double meanSpread;
+};
+
+// Streaming time-bucket resampler, driven from inside the replay loop.
+//
+// Call onEvent() once per message *after* it has been applied to the book.
+// Bucket boundaries are detected from the message timestamp; when an event
+// lands in a later bucket, the open bucket is closed using the book state
+// recorded after its last event, and any empty buckets in between are
+// emitted with that state carried forward. Several widths are maintained in
+// the same pass. Each bar goes to the sink as it closes (e.g. a BarWriter) and
+// is not kept, so memory is the fixed per-width accumulator however long the day.
+class Resampler {
+public:
+    // Receives (width index, bar) for every closed bucket, in time order per width
+    using BarSink = std::function<void(size_t, const Bar&)>;
+
+    // Widths under a microsecond are rejected: across a gap in the day they
+    // would emit billions of carried-forward bars
+    Resampler(const std::vector<double>& widthsSeconds, BarSink sink) : sink_(std::move(sink)) {
+        states_.reserve(widthsSeconds.size());
+        for (double width : widthsSeconds) {
+            if (!(width >= 1e-6)) throw std::invalid_argument("Resampler: bucket width must be at least 1us, got " + std::to_string(width));
+            WidthState state;
+            state.widthNs = static_cast<int64_t>(std::llround(width * 1e9));
+            states_.push_back(state);
+        }
+    }
+
+    void onEvent(const RAWMessage& msg, const TopOfBook& top) {
+        const int64_t tsNs = static_cast<int64_t>(std::llround(msg.timestamp * 1e9));
+        const bool isTrade = (msg.type == 4 || msg.type == 5);
+        const bool hasSpread = (top.bidPrice != INVALID_PRICE && top.askPrice != INVALID_PRICE);
+        const double spread = hasSpread ? static_cast<double>(top.askPrice - top.bidPrice) : 0.0;
+
+        for (size_t w = 0; w < states_.size(); ++w) {
+            WidthState& s = states_[w];
+            const int64_t bucket = tsNs / s.widthNs;
+
+            if (!s.open) {
+                s.open = true;
+                s.bucket = bucket;
+            } else if (bucket > s.bucket) {
+                emit(w, s);
+                // Empty buckets between the closed one and this event
+                for (int64_t b = s.bucket + 1; b < bucket; ++b) {
+                    s.bucket = b;
+                    emit(w, s);
+                }
+                s.bucket = bucket;
+            }
+
+            s.last = top;
+            s.eventCount++;
+            if (hasSpread) {
+                s.lastSpread = spread;
+                s.spreadSum += spread;
+                s.spreadSamples++;
+            }
+            if (isTrade) {
+                if (s.tradeCount == 0) {
+                    s.openPx = s.highPx = s.lowPx = msg.price;
+                } else {
+                    if (msg.price > s.highPx) s.highPx = msg.price;
+                    if (msg.price < s.lowPx) s.lowPx = msg.price;
+                }
+                s.closePx = msg.price;
+                s.volume += msg.size;
+                s.notional += static_cast<double>(msg.price) * static_cast<double>(msg.size);
+                s.tradeCount++;
+            }
+        }
+    }
+
+    // Close the open bucket of every width (end of replay)
+    void flush() {
+        for (size_t w = 0; w < states_.size(); ++w) {
+            WidthState& s = states_[w];
+            if (!s.open) continue;
+            emit(w, s);
+            s.open = false;
+        }
+    }
+
+    size_t widthCount() const { return states_.size(); }
+    double widthSeconds(size_t w) const { return static_cast<double>(states_[w].widthNs) / 1e9; }
+
+private:
+    struct WidthState {
+        int64_t widthNs = 0;
+        int64_t bucket = 0;
+        bool open = false;
+
+        // Carried across buckets
+        TopOfBook last;
+        double lastSpread = 0.0;
+
+        // Reset per bucket
+        Price openPx = INVALID_PRICE;
+        Price highPx = INVALID_PRICE;
+        Price lowPx = INVALID_PRICE;
+        Price closePx = INVALID_PRICE;
+        Quantity volume = 0;
+        double notional = 0.0;
+        uint32_t tradeCount = 0;
+        uint32_t eventCount = 0;
+        double spreadSum = 0.0;
+        uint32_t spreadSamples = 0;
+    };
+
+    std::vector<WidthState> states_;
+    BarSink sink_;
+
+    void emit(size_t w, WidthState& s) {
+        Bar bar;
+        bar.startTime = static_cast<double>(s.bucket) * static_cast<double>(s.widthNs) / 1e9;
+        bar.bidPrice = s.last.bidPrice;
+        bar.bidSize = s.last.bidSize;
+        bar.askPrice = s.last.askPrice;
+        bar.askSize = s.last.askSize;
+        bar.open = s.tradeCount ? s.openPx : INVALID_PRICE;
+        bar.high = s.tradeCount ? s.highPx : INVALID_PRICE;
+        bar.low = s.tradeCount ? s.lowPx : INVALID_PRICE;
+        bar.close = s.tradeCount ? s.closePx : INVALID_PRICE;
+        bar.volume = s.volume;
+        bar.vwap = s.volume ? s.notional / static_cast<double>(s.volume) : 0.0;
+        bar.tradeCount = s.tradeCount;
+        bar.eventCount = s.eventCount;
+        bar.meanSpread = s.spreadSamples ? s.spreadSum / static_cast<double>(s.spreadSamples) : s.lastSpread;
+        sink_(w, bar);
+
+        s.volume = 0;
+        s.notional = 0.0;
+        s.tradeCount = 0;
+        s.eventCount = 0;
+        s.spreadSum = 0.0;
+        s.spreadSamples = 0;
+    }
+};
+
+// Streams one width's bars to `<directory>/<column>.npy` as they close (see ColumnarWriter)
+class BarWriter {
+public:
+    explicit BarWriter(const std::string& directory, size_t chunkRows = 1024)
+        : writer_(directory, {{"start_time", ColumnType::Float64}, {"bid_px", ColumnType::Int64}, {"bid_sz", ColumnType::UInt64},
+                              {"ask_px", ColumnType::Int64}, {"ask_sz", ColumnType::UInt64}, {"open", ColumnType::Int64},
+                              {"high", ColumnType::Int64}, {"low", ColumnType::Int64}, {"close", ColumnType::Int64},
+                              {"volume", ColumnType::UInt64}, {"vwap", ColumnType::Float64}, {"trade_count", ColumnType::UInt32},
+                              {"event_count", ColumnType::UInt32}, {"mean_spread", ColumnType::Float64}},
+                  chunkRows, 4) {}
+
+    void write(const Bar& bar) {
+        writer_.set<double>(0, bar.startTime);
+        writer_.set<Price>(1, bar.bidPrice);
+        writer_.set<Quantity>(2, bar.bidSize);
+        writer_.set<Price>(3, bar.askPrice);
+        writer_.set<Quantity>(4, bar.askSize);
+        writer_.set<Price>(5, bar.open);
+        writer_.set<Price>(6, bar.high);
+        writer_.set<Price>(7, bar.low);
+        writer_.set<Price>(8, bar.close);
+        writer_.set<Quantity>(9, bar.volume);
+        writer_.set<double>(10, bar.vwap);
+        writer_.set<uint32_t>(11, bar.tradeCount);
+        writer_.set<uint32_t>(12, bar.eventCount);
+        writer_.set<double>(13, bar.meanSpread);
+        writer_.commitRow();
+    }
+
+    uint64_t rows() const { return writer_.rows(); }
+    void close() { writer_.close(); }
+
+private:
+    ColumnarWriter writer_;
+};
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#define LOB_CPU_RELAX() _mm_pause()
+#else
+#define LOB_CPU_RELAX() ((void)0)
+#endif
+
+namespace LOB {
+
+// Single-writer / multi-reader sequence lock.
+// The writer never blocks and never sees readers. Readers copy the payload and
+// retry if the sequence moved underneath them (odd = write in progress).
+// The payload is held as relaxed atomic words so concurrent copies are race-free.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+    SeqLock() {
+        uint64_t buffer[kWords] = {};
+        const T initial{};
+        std::memcpy(buffer, &initial, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+    }
+
+    // Writer side (exactly one thread)
+    void store(const T& value) {
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const uint64_t seq = seq_.load(std::memory_order_relaxed);
+        seq_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        seq_.store(seq + 2, std::memory_order_release);
+    }
+
+    // Reader side (any number of threads). Lock-free; retries only while a write overlaps.
+    T load() const {
+        uint64_t buffer[kWords];
+        for (;;) {
+            const uint64_t before = seq_.load(std::memory_order_acquire);
+            if (before & 1) {
+                LOB_CPU_RELAX();
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // Number of completed stores
+    uint64_t version() const { return seq_.load(std::memory_order_acquire) / 2; }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    alignas(64) std::atomic<uint64_t> seq_{0};
+    std::atomic<uint64_t> words_[kWords];
+};
+
+}
@@ -1,71 +1,307 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <stdexcept>
 #include <memory>
+#include <mutex>
+#include <new>
 
 namespace LOB {
 
-template <typename T, size_t BlockSize = 10000>
+// Process-wide cache of fixed-size, BlockBytes-aligned raw blocks shared by
+// every SlabAllocator with the same block size (i.e. every book in the process).
+//
+// Books take blocks as they grow and give fully free blocks back, so memory
+// follows the number of live orders across all books instead of each book's
+// peak. Returned blocks stay cached for the next book that needs one until
+// the cache holds more than twice the blocks in use (and more than
+// keepBlocks); then it is cut back to that many, so the blocks of a burst go
+// back to the system once it is over. trim() frees cached blocks on demand.
+// Block exchange is the cold path of SlabAllocator (once per few hundred
+// orders) and takes a mutex.
+template <size_t BlockBytes>
+class BlockPool {
+    static_assert((BlockBytes & (BlockBytes - 1)) == 0, "block size must be a power of two");
+
+public:
+    static BlockPool& shared() {
+        static BlockPool pool;
+        return pool;
+    }
+
+    explicit BlockPool(size_t keepBlocks = 16) : keep_(keepBlocks) {}
+    ~BlockPool() { trim(0); }
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    void* acquire() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            outstanding_++;
+            if (!cached_.empty()) {
+                void* block = cached_.back();
+                cached_.pop_back();
+                return block;
+            }
+        }
+        try {
+            return ::operator new(BlockBytes, std::align_val_t(BlockBytes));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            outstanding_--;
+            throw;
+        }
+    }
+
+    void release(void* block) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        outstanding_--;
+        cached_.push_back(block);
+        if (cached_.size() > std::max(keep_, 2 * outstanding_)) freeCached(std::max(keep_, outstanding_));
+    }
+
+    // Pre-fault blocks so early growth never reaches the system allocator;
+    // they are kept through later releases
+    void reserve(size_t blocks) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        keep_ = std::max(keep_, blocks);
+        while (cached_.size() < blocks) {
+            cached_.push_back(::operator new(BlockBytes, std::align_val_t(BlockBytes)));
+        }
+    }
+
+    // Free cached blocks until at most `keep` remain
+    void trim(size_t keep = 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        freeCached(keep);
+    }
+
+    size_t outstandingBlocks() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return outstanding_;
+    }
+
+    size_t cachedBlocks() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cached_.size();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<void*> cached_;
+    size_t outstanding_ = 0;
+    size_t keep_;
+
+    void freeCached(size_t keep) {
+        while (cached_.size() > keep) {
+            ::operator delete(cached_.back(), std::align_val_t(BlockBytes));
+            cached_.pop_back();
+        }
+    }
+};
+
+// Fixed-size object allocator built from BlockPool blocks.
+//
+// Each block starts with a small header (its own free list and live count)
+// followed by as many T as fit; an object's block is found by masking its
+// address, so deallocate() needs no lookup. Free objects are chained through
+// T::next, as before.
+//
+// Sizing policy:
+//  - the capacity hint is allocated up front and never given back (a reserve);
+//  - beyond it, blocks are taken from the pool when every block is full;
+//  - a block that becomes completely free is returned to the pool while the
+//    slab is above its hint and already holds an empty block; that one empty
+//    spare absorbs add/cancel churn at a block boundary.
+// Allocation prefers partially used blocks, so blocks drain and can be returned.
+// The steady state never calls the system allocator.
+template <typename T, size_t BlockBytes = 16384>
 class SlabAllocator {
+    struct BlockHeader {
+        BlockHeader* prevPartial;
+        BlockHeader* nextPartial;
+        BlockHeader* prevBlock;
+        BlockHeader* nextBlock;
+        T* freeList;
+        uint32_t live;
+    };
+
+    static constexpr size_t kObjectOffset = (sizeof(BlockHeader) + alignof(T) - 1) / alignof(T) * alignof(T);
+    static_assert(alignof(T) <= BlockBytes && kObjectOffset + sizeof(T) <= BlockBytes, "block too small for T");
+
 public:
-    SlabAllocator(size_t initialCapacity = 1000000) {
-        // Pre-allocate to avoid resizing during trading day
-        size_t blocksNeeded = (initialCapacity + BlockSize - 1) / BlockSize;
-        for (size_t i = 0; i < blocksNeeded; ++i) {
-            allocateBlock();
+    using Pool = BlockPool<BlockBytes>;
+
+    static constexpr size_t kObjectsPerBlock = (BlockBytes - kObjectOffset) / sizeof(T);
+
+    explicit SlabAllocator(size_t initialCapacity = 1000000, Pool& pool = Pool::shared()) : pool_(pool) {
+        // Pre-allocate to avoid growing during trading day
+        minBlocks_ = (initialCapacity + kObjectsPerBlock - 1) / kObjectsPerBlock;
+        for (size_t i = 0; i < minBlocks_; ++i) {
+            addBlock();
         }
     }
 
     ~SlabAllocator() {
-        for (void* block : blocks_) {
-            ::operator delete(block);
+        while (blocks_) {
+            BlockHeader* block = blocks_;
+            blocks_ = block->nextBlock;
+            pool_.release(block);
         }
     }
 
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+
     T* allocate() {
-        if (freeList_ == nullptr) {
-            allocateBlock();
+        BlockHeader* block = partial_;
+        if (block == nullptr) {
+            block = addBlock();
         }
-        
-        T* object = freeList_;
-        freeList_ = freeList_->next; // Using 'next' pointer from the object itself (union/reinterpret_cast pattern)
-        
-        // Use placement new to call constructor if needed, or assume manual construction.
-        // For POD/trivial types like Order, we might just call a reset method.
+
+        T* object = block->freeList;
+        block->freeList = object->next; // Using 'next' pointer from the object itself (union/reinterpret_cast pattern)
+        if (block->live++ == 0) emptyBlocks_--;
+        if (block->live == kObjectsPerBlock) unlinkPartial(block);
+        liveObjects_++;
+
         // Here we just return the raw ptr, user calls placement new or init.
         return object;
     }
 
     void deallocate(T* object) {
         if (!object) return;
-        
-        // We assume T has a 'next' pointer or sufficient size to store a pointer.
-        // For Order struct, it has 'next'. We reuse that field for the free list.
-        object->next = freeList_;
-        freeList_ = object;
+
+        BlockHeader* block = headerOf(object);
+        // We reuse the 'next' field for the free list.
+        object->next = block->freeList;
+        block->freeList = object;
+        liveObjects_--;
+        if (block->live-- == kObjectsPerBlock) pushPartialFront(block);
+        if (block->live == 0) onBlockEmptied(block);
+    }
+
+    // Return every object to the free list and shrink back to the capacity hint.
+    // Objects handed out before the reset must no longer be used.
+    void reset() {
+        partial_ = nullptr;
+        partialTail_ = nullptr;
+        emptyBlocks_ = 0;
+        liveObjects_ = 0;
+        size_t kept = 0;
+        for (BlockHeader* block = blocks_; block != nullptr;) {
+            BlockHeader* next = block->nextBlock;
+            if (kept < minBlocks_) {
+                linkBlock(block);
+                pushPartialBack(block);
+                emptyBlocks_++;
+                kept++;
+            } else {
+                unlinkBlock(block);
+                pool_.release(block);
+            }
+            block = next;
+        }
     }
 
+    // Address of the block header deallocate(object) will update (for prefetching)
+    static const void* blockOf(const T* object) {
+        return reinterpret_cast<const void*>(reinterpret_cast<uintptr_t>(object) & ~uintptr_t(BlockBytes - 1));
+    }
+
+    size_t capacity() const { return blockCount_ * kObjectsPerBlock; }
+    size_t blockCount() const { return blockCount_; }
+    size_t liveObjects() const { return liveObjects_; }
+    // Bytes of blocks currently held (live objects plus free slots)
+    size_t memoryUsage() const { return blockCount_ * BlockBytes; }
+
 private:
-    std::vector<void*> blocks_;
-    T* freeList_ = nullptr;
-
-    void allocateBlock() {
-        // Allocate raw memory for BlockSize items
-        size_t sizeBytes = sizeof(T) * BlockSize;
-        // Ensure alignment
-        void* rawMemory = ::operator new(sizeBytes); 
-        blocks_.push_back(rawMemory);
-
-        T* start = static_cast<T*>(rawMemory);
-        
-        // Link all new objects into the free list
-        for (size_t i = 0; i < BlockSize - 1; ++i) {
+    Pool& pool_;
+    BlockHeader* blocks_ = nullptr;      // every held block
+    BlockHeader* partial_ = nullptr;     // blocks with a free slot; allocation takes the front
+    BlockHeader* partialTail_ = nullptr;
+    size_t blockCount_ = 0;
+    size_t minBlocks_ = 0;
+    size_t emptyBlocks_ = 0;
+    size_t liveObjects_ = 0;
+
+    static BlockHeader* headerOf(T* object) {
+        return reinterpret_cast<BlockHeader*>(reinterpret_cast<uintptr_t>(object) & ~uintptr_t(BlockBytes - 1));
+    }
+
+    BlockHeader* addBlock() {
+        auto* block = static_cast<BlockHeader*>(pool_.acquire());
+        block->prevBlock = nullptr;
+        block->nextBlock = blocks_;
+        if (blocks_) blocks_->prevBlock = block;
+        blocks_ = block;
+        blockCount_++;
+
+        linkBlock(block);
+        pushPartialFront(block);
+        emptyBlocks_++;
+        return block;
+    }
+
+    // Thread all objects of the block into its free list
+    void linkBlock(BlockHeader* block) {
+        T* start = reinterpret_cast<T*>(reinterpret_cast<char*>(block) + kObjectOffset);
+        for (size_t i = 0; i < kObjectsPerBlock - 1; ++i) {
             start[i].next = &start[i + 1];
         }
-        start[BlockSize - 1].next = freeList_;
-        freeList_ = &start[0];
+        start[kObjectsPerBlock - 1].next = nullptr;
+        block->freeList = &start[0];
+        block->live = 0;
+    }
+
+    void unlinkBlock(BlockHeader* block) {
+        if (block->prevBlock) block->prevBlock->nextBlock = block->nextBlock;
+        else blocks_ = block->nextBlock;
+        if (block->nextBlock) block->nextBlock->prevBlock = block->prevBlock;
+        blockCount_--;
+    }
+
+    void pushPartialFront(BlockHeader* block) {
+        block->prevPartial = nullptr;
+        block->nextPartial = partial_;
+        if (partial_) partial_->prevPartial = block;
+        else partialTail_ = block;
+        partial_ = block;
+    }
+
+    void pushPartialBack(BlockHeader* block) {
+        block->nextPartial = nullptr;
+        block->prevPartial = partialTail_;
+        if (partialTail_) partialTail_->nextPartial = block;
+        else partial_ = block;
+        partialTail_ = block;
+    }
+
+    void unlinkPartial(BlockHeader* block) {
+        if (block->prevPartial) block->prevPartial->nextPartial = block->nextPartial;
+        else partial_ = block->nextPartial;
+        if (block->nextPartial) block->nextPartial->prevPartial = block->prevPartial;
+        else partialTail_ = block->prevPartial;
+    }
+
+    void onBlockEmptied(BlockHeader* block) {
+        // Keep the first empty block as a spare; give further ones back while above the hint
+        if (emptyBlocks_ >= 1 && blockCount_ > minBlocks_) {
+            unlinkPartial(block);
+            unlinkBlock(block);
+            pool_.release(block);
+            return;
+        }
+        emptyBlocks_++;
+        // Fill other partial blocks first so this one stays empty
+        if (block != partialTail_) {
+            unlinkPartial(block);
+            pushPartialBack(block);
+        }
     }
 };
 
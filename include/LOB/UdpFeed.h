@@ -0,0 +1,609 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LOB/CSVParser.h"
+#include "LOB/LatencyHistogram.h"
+#include "LOB/MemoryMappedFile.h"
+#include "LOB/Message.h"
+
+#if !defined(__linux__)
+#error "UdpFeed.h needs Linux (sendmmsg / recvmmsg)"
+#endif
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace LOB {
+
+// --- Wire format ---
+//
+// One datagram is a FeedPacketHeader followed by `count` FeedRecords, in host
+// byte order (gateway and handler share a host). Packets are numbered
+// consecutively, so the handler spots a drop as a jump in `sequence`. The
+// stream ends with a header-only packet flagged kFeedEndOfStream. While the
+// gateway is idle it sends header-only kFeedHeartbeat packets that carry the
+// next sequence number without using it up, so the handler can tell a quiet
+// market from a dead feed and still sees a gap when the packets before the
+// quiet spell were lost.
+
+constexpr size_t kFeedMaxDatagram = 1472; // 1500-byte MTU minus IP and UDP headers
+constexpr uint16_t kFeedEndOfStream = 1;
+constexpr uint16_t kFeedHeartbeat = 2;
+
+struct FeedPacketHeader {
+    uint64_t sequence;     // packet number: 0, 1, 2, ...
+    uint64_t firstMessage; // message number of the first record
+    int64_t sendNs;        // gateway clock when the packet went to sendmmsg
+    uint16_t count;        // records that follow
+    uint16_t flags;
+    uint32_t reserved;
+};
+
+struct FeedRecord {
+    int64_t timestampNs;   // event time
+    int64_t releaseNs;     // gateway clock when pacing released the message
+    uint64_t orderId;
+    int64_t price;
+    uint32_t size;
+    int8_t type;
+    int8_t direction;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(FeedPacketHeader) == 32 && sizeof(FeedRecord) == 40, "wire structs must not be padded");
+
+constexpr size_t kFeedMaxRecords = (kFeedMaxDatagram - sizeof(FeedPacketHeader)) / sizeof(FeedRecord);
+
+// Monotonic clock shared by gateway and handler (CLOCK_MONOTONIC is system-wide)
+inline int64_t feedClockNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline FeedRecord toFeedRecord(const RAWMessage& msg, int64_t releaseNs) {
+    FeedRecord record{};
+    record.timestampNs = std::llround(msg.timestamp * 1e9);
+    record.releaseNs = releaseNs;
+    record.orderId = msg.orderId;
+    record.price = msg.price;
+    record.size = static_cast<uint32_t>(msg.size);
+    record.type = static_cast<int8_t>(msg.type);
+    record.direction = static_cast<int8_t>(msg.direction);
+    return record;
+}
+
+inline RAWMessage fromFeedRecord(const FeedRecord& record) {
+    return RAWMessage{static_cast<double>(record.timestampNs) * 1e-9, record.type, record.orderId,
+                      record.size, record.price, record.direction};
+}
+
+// --- Binary replay files: FeedRecords back to back ---
+
+inline void writeFeedFile(const std::string& path, std::span<const RAWMessage> messages) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("Failed to open output file: " + path);
+    for (const RAWMessage& msg : messages) {
+        const FeedRecord record = toFeedRecord(msg, 0);
+        out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    if (!out) throw std::runtime_error("Failed to write " + path);
+}
+
+// A day to replay: a binary feed file (*.bin, see writeFeedFile) or LOBSTER messages (.csv / .gz / .zst)
+inline std::vector<RAWMessage> loadFeedMessages(const std::string& path) {
+    std::vector<RAWMessage> messages;
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, ".bin") == 0) {
+        MemoryMappedFile file(path);
+        if (file.size() % sizeof(FeedRecord) != 0) throw std::runtime_error("Truncated feed file: " + path);
+        messages.resize(file.size() / sizeof(FeedRecord));
+        for (size_t i = 0; i < messages.size(); ++i) {
+            FeedRecord record;
+            std::memcpy(&record, file.data() + i * sizeof(FeedRecord), sizeof(record));
+            messages[i] = fromFeedRecord(record);
+        }
+        return messages;
+    }
+    LobsterMessageParser parser(path);
+    RAWMessage msg;
+    while (parser.next(msg)) messages.push_back(msg);
+    return messages;
+}
+
+// --- Sockets ---
+
+struct UdpEndpoint {
+    std::string address = "127.0.0.1";          // unicast address, or a multicast group (224.0.0.0/4)
+    uint16_t port = 0;                          // handler: 0 picks a free port (see UdpFeedHandler::port())
+    std::string interfaceAddress = "127.0.0.1"; // multicast: interface to send on / join on (loopback by default)
+};
+
+[[noreturn]] inline void throwSocketError(const std::string& what) {
+    throw std::runtime_error(what + ": " + std::strerror(errno));
+}
+
+inline in_addr parseIPv4(const std::string& address) {
+    in_addr addr{};
+    if (inet_pton(AF_INET, address.c_str(), &addr) != 1) throw std::runtime_error("Bad IPv4 address: " + address);
+    return addr;
+}
+
+inline bool isMulticast(in_addr addr) { return (ntohl(addr.s_addr) >> 28) == 0xE; }
+
+inline void feedBackoff() {
+#if defined(__x86_64__) || defined(_M_X64)
+    _mm_pause();
+#endif
+    std::this_thread::yield();
+}
+
+// How the gateway releases messages
+struct FeedPacing {
+    double speed = 1.0;       // event-time multiplier: 1 = real time, 10 = ten times faster, 0 = as fast as possible
+    double rate = 0.0;        // > 0: evenly spaced at this many messages/second instead (speed is ignored)
+    int64_t flushNs = 20000;  // longest a message waits for its packet / sendmmsg batch to fill
+    int64_t heartbeatNs = 250000000; // heartbeat after this long without sending (0 = never)
+};
+
+struct GatewayStats {
+    uint64_t messages = 0;
+    uint64_t packets = 0;
+    uint64_t sendCalls = 0;    // sendmmsg calls
+    uint64_t sendRetries = 0;  // ENOBUFS / EAGAIN from a full send queue
+    uint64_t heartbeats = 0;
+    int64_t maxLagNs = 0;      // worst delay between a message's due time and its release
+    double seconds = 0.0;
+
+    double messagesPerSecond() const { return seconds > 0 ? static_cast<double>(messages) / seconds : 0.0; }
+};
+
+// Paces a replay onto a UDP socket.
+//
+// Messages are packed into packets of up to recordsPerPacket records, and
+// packets go out packetsPerSend at a time through one sendmmsg call. Whatever
+// is pending is sent early, in partly filled packets, once it has waited
+// FeedPacing::flushNs or when the next message is not due until later than
+// that, so batching adds a bounded delay at any rate. While waiting for a
+// message that is not yet due, it sends a heartbeat whenever nothing has gone
+// out for FeedPacing::heartbeatNs. All packet buffers are allocated once, up
+// front.
+class UdpGateway {
+public:
+    explicit UdpGateway(const UdpEndpoint& target, size_t recordsPerPacket = kFeedMaxRecords, size_t packetsPerSend = 32)
+        : recordsPerPacket_(std::clamp<size_t>(recordsPerPacket, 1, kFeedMaxRecords)),
+          packetsPerSend_(std::max<size_t>(packetsPerSend, 1)),
+          buffers_(packetsPerSend_ * kFeedMaxDatagram), iov_(packetsPerSend_), msgs_(packetsPerSend_) {
+        dest_.sin_family = AF_INET;
+        dest_.sin_port = htons(target.port);
+        dest_.sin_addr = parseIPv4(target.address);
+        const in_addr iface = parseIPv4(target.interfaceAddress);
+
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd_ < 0) throwSocketError("socket");
+        int sendBuffer = 4 << 20;
+        setsockopt(fd_, SOL_SOCKET, SO_SNDBUF, &sendBuffer, sizeof(sendBuffer));
+        if (isMulticast(dest_.sin_addr)) {
+            const unsigned char loop = 1, ttl = 1;
+            if (setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) != 0 ||
+                setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0 ||
+                setsockopt(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl)) != 0) {
+                const int err = errno;
+                ::close(fd_);
+                errno = err;
+                throwSocketError("multicast setup");
+            }
+        }
+
+        for (size_t i = 0; i < packetsPerSend_; ++i) {
+            iov_[i].iov_base = buffers_.data() + i * kFeedMaxDatagram;
+            msgs_[i].msg_hdr.msg_name = &dest_;
+            msgs_[i].msg_hdr.msg_namelen = sizeof(dest_);
+            msgs_[i].msg_hdr.msg_iov = &iov_[i];
+            msgs_[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    ~UdpGateway() { ::close(fd_); }
+
+    UdpGateway(const UdpGateway&) = delete;
+    UdpGateway& operator=(const UdpGateway&) = delete;
+
+    // Send `messages` on the pacing schedule; returns once the last packet is out.
+    // Sequence numbers carry on across calls.
+    GatewayStats replay(std::span<const RAWMessage> messages, const FeedPacing& pacing = FeedPacing{}) {
+        stats_ = GatewayStats{};
+        if (messages.empty()) return stats_;
+        const bool paced = pacing.rate > 0 || pacing.speed > 0;
+        const int64_t start = feedClockNs();
+        const int64_t firstEventNs = std::llround(messages.front().timestamp * 1e9);
+        auto dueOf = [&](size_t i) -> int64_t {
+            if (pacing.rate > 0) return start + static_cast<int64_t>(static_cast<double>(i) * 1e9 / pacing.rate);
+            return start + static_cast<int64_t>(static_cast<double>(std::llround(messages[i].timestamp * 1e9) - firstEventNs) / pacing.speed);
+        };
+
+        for (size_t i = 0; i < messages.size(); ++i) {
+            int64_t now = feedClockNs();
+            int64_t release = now;
+            if (paced) {
+                release = dueOf(i);
+                if (release > now) {
+                    if (release - now > pacing.flushNs) flush();
+                    now = waitUntil(release, pacing.heartbeatNs);
+                }
+                stats_.maxLagNs = std::max(stats_.maxLagNs, now - release);
+            }
+            if ((pending_ > 0 || packetRecords_ > 0) && now - oldestPendingNs_ > pacing.flushNs) flush();
+            append(toFeedRecord(messages[i], release), now);
+        }
+        flush();
+        stats_.messages = messages.size();
+        stats_.seconds = static_cast<double>(feedClockNs() - start) * 1e-9;
+        return stats_;
+    }
+
+    // Tell handlers the stream is over. Sent a few times, spaced out, in case one is dropped.
+    void endOfStream(int copies = 3) {
+        flush();
+        const uint64_t sequence = nextPacket_++;
+        for (int c = 0; c < copies; ++c) {
+            sendHeader(sequence, kFeedEndOfStream);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Tell handlers the feed is alive. replay() sends these itself while it
+    // waits; call it between replays that are far apart.
+    void heartbeat() {
+        flush();
+        sendHeader(nextPacket_, kFeedHeartbeat);
+        stats_.heartbeats++;
+    }
+
+    uint64_t nextSequence() const { return nextPacket_; }
+    uint64_t nextMessage() const { return nextMessage_; }
+
+private:
+    const size_t recordsPerPacket_;
+    const size_t packetsPerSend_;
+    std::vector<uint8_t> buffers_; // packetsPerSend_ datagrams of kFeedMaxDatagram bytes
+    std::vector<iovec> iov_;
+    std::vector<mmsghdr> msgs_;
+    sockaddr_in dest_{};
+    int fd_ = -1;
+
+    size_t pending_ = 0;       // closed packets waiting for sendmmsg
+    size_t packetRecords_ = 0; // records in the open packet (buffer slot pending_)
+    uint64_t nextPacket_ = 0;
+    uint64_t nextMessage_ = 0;
+    int64_t oldestPendingNs_ = 0; // when the first unsent record was appended
+    int64_t lastSendNs_ = 0;
+    GatewayStats stats_;
+
+    // Sleep while far from `due`, then spin, heartbeating through long waits;
+    // returns the time on waking
+    int64_t waitUntil(int64_t due, int64_t heartbeatNs) {
+        for (;;) {
+            const int64_t now = feedClockNs();
+            if (now >= due) return now;
+            if (heartbeatNs > 0 && now - lastSendNs_ >= heartbeatNs) {
+                heartbeat();
+                continue;
+            }
+            if (due - now > 200000) {
+                int64_t sleepNs = due - now - 100000;
+                if (heartbeatNs > 0) sleepNs = std::min(sleepNs, lastSendNs_ + heartbeatNs - now);
+                std::this_thread::sleep_for(std::chrono::nanoseconds(sleepNs));
+            } else {
+                feedBackoff();
+            }
+        }
+    }
+
+    // Header-only control packet in buffer slot 0; call with nothing pending
+    void sendHeader(uint64_t sequence, uint16_t flags) {
+        FeedPacketHeader header{};
+        header.sequence = sequence;
+        header.firstMessage = nextMessage_;
+        header.flags = flags;
+        std::memcpy(buffers_.data(), &header, sizeof(header));
+        iov_[0].iov_len = sizeof(header);
+        pending_ = 1;
+        sendPending();
+    }
+
+    void append(const FeedRecord& record, int64_t now) {
+        if (pending_ == 0 && packetRecords_ == 0) oldestPendingNs_ = now;
+        uint8_t* packet = buffers_.data() + pending_ * kFeedMaxDatagram;
+        std::memcpy(packet + sizeof(FeedPacketHeader) + packetRecords_ * sizeof(FeedRecord), &record, sizeof(record));
+        if (++packetRecords_ == recordsPerPacket_) closePacket();
+    }
+
+    void closePacket() {
+        FeedPacketHeader header{};
+        header.sequence = nextPacket_++;
+        header.firstMessage = nextMessage_;
+        header.count = static_cast<uint16_t>(packetRecords_);
+        std::memcpy(buffers_.data() + pending_ * kFeedMaxDatagram, &header, sizeof(header));
+        iov_[pending_].iov_len = sizeof(FeedPacketHeader) + packetRecords_ * sizeof(FeedRecord);
+        nextMessage_ += packetRecords_;
+        packetRecords_ = 0;
+        stats_.packets++;
+        if (++pending_ == packetsPerSend_) sendPending();
+    }
+
+    void flush() {
+        if (packetRecords_ > 0) closePacket();
+        if (pending_ > 0) sendPending();
+    }
+
+    void sendPending() {
+        const int64_t now = feedClockNs();
+        for (size_t i = 0; i < pending_; ++i) {
+            std::memcpy(buffers_.data() + i * kFeedMaxDatagram + offsetof(FeedPacketHeader, sendNs), &now, sizeof(now));
+        }
+        size_t sent = 0;
+        while (sent < pending_) {
+            const int n = sendmmsg(fd_, msgs_.data() + sent, static_cast<unsigned>(pending_ - sent), 0);
+            stats_.sendCalls++;
+            if (n > 0) {
+                sent += static_cast<size_t>(n);
+            } else if (errno == ENOBUFS || errno == EAGAIN || errno == EWOULDBLOCK) {
+                stats_.sendRetries++;
+                feedBackoff();
+            } else if (errno != EINTR) {
+                throwSocketError("sendmmsg");
+            }
+        }
+        pending_ = 0;
+        lastSendNs_ = now;
+    }
+};
+
+struct FeedHandlerConfig {
+    size_t batchPackets = 64;         // datagrams per recvmmsg
+    int receiveBufferBytes = 8 << 20; // kernel queue that absorbs bursts while the book is busy
+    int idleTimeoutMs = 2000;         // stop after this long without a packet, heartbeats included
+};
+
+struct FeedStats {
+    uint64_t packets = 0;        // in-sequence data packets applied
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    uint64_t recvCalls = 0;      // recvmmsg calls that returned packets
+    uint64_t gaps = 0;           // times the packet sequence jumped
+    uint64_t missedPackets = 0;
+    uint64_t missedMessages = 0;
+    uint64_t stale = 0;          // duplicate or out-of-order packets (ignored)
+    uint64_t malformed = 0;
+    uint64_t heartbeats = 0;
+    bool endOfStream = false;
+    double seconds = 0.0;        // first packet to last
+
+    double messagesPerSecond() const { return seconds > 0 ? static_cast<double>(messages) / seconds : 0.0; }
+};
+
+// Receives a gateway's packets and applies them to a book.
+//
+// recvmmsg fills up to batchPackets preallocated datagram buffers per call;
+// each in-sequence packet's records go to the book through one applyBatch.
+// A jump in the packet sequence is counted as a gap (with the packets and
+// messages it lost) and the handler carries on from the new sequence; the
+// book may then disagree with the source, as it would on a real feed until a
+// snapshot recovery. Heartbeats keep an idle feed alive and reveal a gap
+// before a quiet spell; if the feed still goes silent for idleTimeoutMs, run()
+// returns without end of stream, and countLostTail() can charge what never
+// arrived as a final gap. Latencies are kept in two histograms:
+//   per-packet   packet handed to sendmmsg -> returned by recvmmsg
+//   end-to-end   message released by the gateway's pacing -> applied to the book
+class UdpFeedHandler {
+public:
+    explicit UdpFeedHandler(const UdpEndpoint& listen, const FeedHandlerConfig& config = FeedHandlerConfig{})
+        : config_(config), batch_(std::max<size_t>(config.batchPackets, 1)),
+          buffers_(batch_ * kFeedMaxDatagram), iov_(batch_), msgs_(batch_), messages_(kFeedMaxRecords),
+          releases_(kFeedMaxRecords) {
+        fd_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd_ < 0) throwSocketError("socket");
+        try {
+            const int one = 1;
+            setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            // SO_RCVBUFFORCE may exceed net.core.rmem_max but needs CAP_NET_ADMIN
+            if (setsockopt(fd_, SOL_SOCKET, SO_RCVBUFFORCE, &config.receiveBufferBytes, sizeof(int)) != 0) {
+                setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &config.receiveBufferBytes, sizeof(int));
+            }
+
+            sockaddr_in local{};
+            local.sin_family = AF_INET;
+            local.sin_port = htons(listen.port);
+            local.sin_addr = parseIPv4(listen.address);
+            if (bind(fd_, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) throwSocketError("bind " + listen.address);
+            if (isMulticast(local.sin_addr)) {
+                ip_mreq membership{};
+                membership.imr_multiaddr = local.sin_addr;
+                membership.imr_interface = parseIPv4(listen.interfaceAddress);
+                if (setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) != 0) {
+                    throwSocketError("join " + listen.address);
+                }
+            }
+            socklen_t length = sizeof(local);
+            if (getsockname(fd_, reinterpret_cast<sockaddr*>(&local), &length) != 0) throwSocketError("getsockname");
+            port_ = ntohs(local.sin_port);
+        } catch (...) {
+            ::close(fd_);
+            throw;
+        }
+
+        for (size_t i = 0; i < batch_; ++i) {
+            iov_[i].iov_base = buffers_.data() + i * kFeedMaxDatagram;
+            iov_[i].iov_len = kFeedMaxDatagram;
+            msgs_[i].msg_hdr.msg_iov = &iov_[i];
+            msgs_[i].msg_hdr.msg_iovlen = 1;
+        }
+    }
+
+    ~UdpFeedHandler() { ::close(fd_); }
+
+    UdpFeedHandler(const UdpFeedHandler&) = delete;
+    UdpFeedHandler& operator=(const UdpFeedHandler&) = delete;
+
+    uint16_t port() const { return port_; }
+
+    // Kernel receive queue actually granted (Linux reports twice the usable bytes)
+    int receiveBufferBytes() const {
+        int bytes = 0;
+        socklen_t length = sizeof(bytes);
+        getsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &bytes, &length);
+        return bytes;
+    }
+
+    // Receive and apply until end of stream, idle timeout or stop()
+    template <typename Book>
+    FeedStats run(Book& book) {
+        pollfd ready{fd_, POLLIN, 0};
+        int idleMs = 0;
+        while (!stats_.endOfStream && !stopRequested_.load(std::memory_order_relaxed)) {
+            const int n = recvmmsg(fd_, msgs_.data(), static_cast<unsigned>(batch_), MSG_DONTWAIT, nullptr);
+            if (n > 0) {
+                const int64_t received = feedClockNs();
+                stats_.recvCalls++;
+                for (int k = 0; k < n && !stats_.endOfStream; ++k) {
+                    if (msgs_[k].msg_hdr.msg_flags & MSG_TRUNC) {
+                        stats_.malformed++;
+                        continue;
+                    }
+                    onPacket(book, buffers_.data() + static_cast<size_t>(k) * kFeedMaxDatagram, msgs_[k].msg_len, received);
+                }
+                idleMs = 0;
+                continue;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) throwSocketError("recvmmsg");
+
+            // Queue empty: block until more arrives
+            const int polled = poll(&ready, 1, kPollSliceMs);
+            if (polled < 0 && errno != EINTR) throwSocketError("poll");
+            if (polled == 0 && (idleMs += kPollSliceMs) >= config_.idleTimeoutMs) break;
+        }
+        stats_.seconds = static_cast<double>(lastNs_ - firstNs_) * 1e-9;
+        return stats_;
+    }
+
+    // Any thread: make run() return within one poll slice
+    void stop() { stopRequested_.store(true, std::memory_order_relaxed); }
+
+    // After run() returned without end of stream: the gateway's final
+    // nextSequence() / nextMessage(). Whatever never arrived counts as a gap.
+    void countLostTail(uint64_t nextSequence, uint64_t nextMessage) {
+        if (stats_.endOfStream || nextSequence <= expectedPacket_) return;
+        stats_.gaps++;
+        stats_.missedPackets += nextSequence - expectedPacket_;
+        stats_.missedMessages += nextMessage - expectedMessage_;
+        expectedPacket_ = nextSequence;
+        expectedMessage_ = nextMessage;
+    }
+
+    // One datagram as received at `receivedNs`. run() calls this; it is public
+    // so tests can feed crafted packets.
+    template <typename Book>
+    void onPacket(Book& book, const uint8_t* data, size_t size, int64_t receivedNs) {
+        FeedPacketHeader header;
+        if (size < sizeof(header)) {
+            stats_.malformed++;
+            return;
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (header.count > kFeedMaxRecords || size != sizeof(header) + header.count * sizeof(FeedRecord) ||
+            ((header.flags & kFeedHeartbeat) && header.count != 0)) {
+            stats_.malformed++;
+            return;
+        }
+        if (header.flags & kFeedHeartbeat) {
+            // Names the next packet to come; a late one is simply ignored
+            stats_.heartbeats++;
+            if (header.sequence > expectedPacket_) {
+                stats_.gaps++;
+                stats_.missedPackets += header.sequence - expectedPacket_;
+                stats_.missedMessages += header.firstMessage - expectedMessage_;
+                expectedPacket_ = header.sequence;
+                expectedMessage_ = header.firstMessage;
+            }
+            return;
+        }
+        if (firstNs_ == 0) firstNs_ = receivedNs;
+        lastNs_ = receivedNs;
+
+        if (header.sequence < expectedPacket_) {
+            stats_.stale++;
+            return;
+        }
+        if (header.sequence > expectedPacket_) {
+            stats_.gaps++;
+            stats_.missedPackets += header.sequence - expectedPacket_;
+            stats_.missedMessages += header.firstMessage - expectedMessage_;
+        }
+        expectedPacket_ = header.sequence + 1;
+        expectedMessage_ = header.firstMessage + header.count;
+        if (header.flags & kFeedEndOfStream) {
+            stats_.endOfStream = true;
+            return;
+        }
+
+        stats_.packets++;
+        stats_.bytes += size;
+        packetLatency_.record(receivedNs - header.sendNs);
+        for (size_t k = 0; k < header.count; ++k) {
+            FeedRecord record;
+            std::memcpy(&record, data + sizeof(header) + k * sizeof(FeedRecord), sizeof(record));
+            messages_[k] = fromFeedRecord(record);
+            releases_[k] = record.releaseNs;
+        }
+        book.applyBatch(std::span<const RAWMessage>(messages_.data(), header.count));
+        const int64_t applied = feedClockNs();
+        for (size_t k = 0; k < header.count; ++k) endToEnd_.record(applied - releases_[k]);
+        stats_.messages += header.count;
+    }
+
+    const FeedStats& stats() const { return stats_; }
+    const LatencyHistogram& packetLatency() const { return packetLatency_; }
+    const LatencyHistogram& endToEndLatency() const { return endToEnd_; }
+
+private:
+    static constexpr int kPollSliceMs = 50;
+
+    const FeedHandlerConfig config_;
+    const size_t batch_;
+    std::vector<uint8_t> buffers_; // batch_ datagrams of kFeedMaxDatagram bytes
+    std::vector<iovec> iov_;
+    std::vector<mmsghdr> msgs_;
+    std::vector<RAWMessage> messages_; // one packet's records, decoded
+    std::vector<int64_t> releases_;
+    int fd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stopRequested_{false};
+
+    uint64_t expectedPacket_ = 0;
+    uint64_t expectedMessage_ = 0;
+    int64_t firstNs_ = 0;
+    int64_t lastNs_ = 0;
+    FeedStats stats_;
+    LatencyHistogram packetLatency_;
+    LatencyHistogram endToEnd_;
+};
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace LOB {
+
+struct WorkStealingStats {
+    std::vector<size_t> executed; // jobs run, per worker
+    std::vector<size_t> stolen;   // of those, taken from another worker's queue
+};
+
+// Run task(worker, job) for every job on `workerCount` threads.
+//
+// `jobs` is in priority order (e.g. largest file first). They are dealt
+// round-robin into per-worker deques, so every worker starts on its share of
+// the big jobs. A worker takes from the front of its own deque; once it is
+// empty it steals from the back of the others (their smallest remaining jobs),
+// which keeps owners on the expensive work and thieves on the cheap tail.
+//
+// Jobs are coarse (whole files), so each deque is a plain mutex-protected
+// std::deque. The worker index passed to `task` is stable for the thread, so
+// per-worker state (an OrderBook to reset and reuse) can be indexed by it.
+// The first exception thrown by a task is rethrown after all workers finish.
+template <typename Task>
+WorkStealingStats runWorkStealing(size_t workerCount, const std::vector<size_t>& jobs, Task&& task) {
+    if (workerCount == 0) workerCount = 1;
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<size_t> jobs;
+    };
+    std::vector<Queue> queues(workerCount);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        queues[i % workerCount].jobs.push_back(jobs[i]);
+    }
+
+    WorkStealingStats stats;
+    stats.executed.assign(workerCount, 0);
+    stats.stolen.assign(workerCount, 0);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+
+    auto worker = [&](size_t self) {
+        for (;;) {
+            size_t job = 0;
+            bool found = false;
+            bool stolen = false;
+            {
+                std::lock_guard<std::mutex> lock(queues[self].mutex);
+                if (!queues[self].jobs.empty()) {
+                    job = queues[self].jobs.front();
+                    queues[self].jobs.pop_front();
+                    found = true;
+                }
+            }
+            for (size_t k = 1; !found && k < workerCount; ++k) {
+                Queue& victim = queues[(self + k) % workerCount];
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                if (!victim.jobs.empty()) {
+                    job = victim.jobs.back();
+                    victim.jobs.pop_back();
+                    found = stolen = true;
+                }
+            }
+            // Jobs are never added after start, so all queues empty means done
+            if (!found) return;
+
+            try {
+                task(self, job);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) error = std::current_exception();
+            }
+            stats.executed[self]++;
+            if (stolen) stats.stolen[self]++;
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t w = 1; w < workerCount; ++w) {
+        threads.emplace_back(worker, w);
+    }
+    worker(0);
+    for (auto& t : threads) t.join();
+
+    if (error) std::rethrow_exception(error);
+    return stats;
+}
+
+}
@@ -1,8 +1,16 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 #include "LOB/OrderBook.h"
+#include "LOB/EventStream.h"
+#include "LOB/FlowToxicity.h"
 
 namespace py = pybind11;
 
+PYBIND11_NUMPY_DTYPE_EX(LOB::EventRecord, timestamp, "timestamp", type, "type", direction, "direction",
+                        orderId, "order_id", size, "size", price, "price", bidPrice, "bid_price",
+                        bidSize, "bid_size", askPrice, "ask_price", askSize, "ask_size");
+
 PYBIND11_MODULE(lob_core, m) {
     m.doc() = "High-Performance LOBSTER Limit Order Book Engine";
 
@@ -11,8 +19,33 @@ PYBIND11_MODULE(lob_core, m) {
         .value("Sell", LOB::Side::Sell)
         .export_values();
 
+    py::class_<LOB::RAWMessage>(m, "Message")
+        .def(py::init([](double timestamp, int type, uint64_t orderId, uint64_t size, int64_t price, int direction) {
+                 return LOB::RAWMessage{timestamp, type, orderId, size, price, direction};
+             }),
+             py::arg("timestamp"), py::arg("type"), py::arg("order_id"), py::arg("size"), py::arg("price"), py::arg("direction"))
+        .def_readwrite("timestamp", &LOB::RAWMessage::timestamp)
+        .def_readwrite("type", &LOB::RAWMessage::type)
+        .def_readwrite("order_id", &LOB::RAWMessage::orderId)
+        .def_readwrite("size", &LOB::RAWMessage::size)
+        .def_readwrite("price", &LOB::RAWMessage::price)
+        .def_readwrite("direction", &LOB::RAWMessage::direction);
+
+    py::class_<LOB::TopOfBook>(m, "TopOfBook")
+        .def(py::init([](LOB::Price bidPrice, LOB::Quantity bidSize, LOB::Price askPrice, LOB::Quantity askSize) {
+                 return LOB::TopOfBook{bidPrice, bidSize, askPrice, askSize};
+             }),
+             py::arg("bid_price"), py::arg("bid_size"), py::arg("ask_price"), py::arg("ask_size"))
+        .def_readonly("bid_price", &LOB::TopOfBook::bidPrice)
+        .def_readonly("bid_size", &LOB::TopOfBook::bidSize)
+        .def_readonly("ask_price", &LOB::TopOfBook::askPrice)
+        .def_readonly("ask_size", &LOB::TopOfBook::askSize);
+
     py::class_<LOB::OrderBook>(m, "OrderBook")
         .def(py::init<>())
+        .def(py::init<size_t>(), py::arg("expected_orders"), "Size the book for the expected number of resting orders")
+        .def("memory_usage", [](const LOB::OrderBook& book) { return book.memoryUsage().total(); },
+             "Bytes held by the book (slab blocks, index, levels, ladders)")
         .def("add_order", &LOB::OrderBook::addOrder, "Add a new order")
         .def("cancel_order", &LOB::OrderBook::cancelOrder, "Cancel an order by ID")
         .def("delete_order", &LOB::OrderBook::deleteOrder, "Delete an order by ID (with fallback)")
@@ -20,5 +53,74 @@ PYBIND11_MODULE(lob_core, m) {
         .def("get_best_bid", &LOB::OrderBook::getBestBid, "Get Best Bid Price")
         .def("get_best_ask", &LOB::OrderBook::getBestAsk, "Get Best Ask Price")
         .def("get_obi", &LOB::OrderBook::getOBI, "Calculate Order Book Imbalance")
-        .def("get_microprice", &LOB::OrderBook::getMicroprice, "Calculate Microprice");
+        .def("get_microprice", &LOB::OrderBook::getMicroprice, "Calculate Microprice")
+        .def("apply", &LOB::OrderBook::apply, "Apply one LOBSTER message")
+        .def("get_top_of_book", &LOB::OrderBook::getTopOfBook, "Best bid/ask and their sizes");
+
+    py::class_<LOB::ReplayStats>(m, "ReplayStats")
+        .def_readonly("messages", &LOB::ReplayStats::messages)
+        .def_readonly("mismatches", &LOB::ReplayStats::mismatches)
+        .def_readonly("heals", &LOB::ReplayStats::heals)
+        .def_readonly("seconds", &LOB::ReplayStats::seconds);
+
+    m.attr("event_dtype") = py::dtype::of<LOB::EventRecord>();
+
+    // Iterating yields structured arrays (event_dtype) of up to chunk_size events.
+    // The arrays view the C++ chunk directly; the chunk is recycled once Python drops them.
+    py::class_<LOB::EventStream>(m, "EventStream")
+        .def(py::init<std::string, std::string, size_t, size_t, size_t>(), py::arg("messages"),
+             py::arg("orderbook") = "", py::arg("chunk_size") = 65536, py::arg("prefetch") = 2,
+             py::arg("expected_orders") = 1000000,
+             "Replay a LOBSTER message file on a background thread (verified against `orderbook` if given)")
+        .def("__iter__", [](LOB::EventStream& stream) -> LOB::EventStream& { return stream; })
+        .def("__next__", [](LOB::EventStream& stream) {
+            std::shared_ptr<const LOB::EventChunk> chunk;
+            {
+                // The producer keeps decoding while we wait; don't hold up other Python threads either
+                py::gil_scoped_release release;
+                chunk = stream.next();
+            }
+            if (!chunk) throw py::stop_iteration();
+            auto* owner = new std::shared_ptr<const LOB::EventChunk>(chunk);
+            py::capsule keepAlive(owner, [](void* p) { delete static_cast<std::shared_ptr<const LOB::EventChunk>*>(p); });
+            py::array_t<LOB::EventRecord> array(chunk->records.size(), chunk->records.data(), keepAlive);
+            array.attr("flags").attr("writeable") = false; // shared with the recycled chunk
+            return array;
+        })
+        .def_property_readonly("stats", &LOB::EventStream::stats,
+                               "Replay statistics (a copy); raises RuntimeError until the replay has finished")
+        .def_property_readonly("chunk_size", &LOB::EventStream::chunkSize);
+
+    py::class_<LOB::ToxicityConfig>(m, "ToxicityConfig")
+        .def(py::init<>())
+        .def_readwrite("bucket_volume", &LOB::ToxicityConfig::bucketVolume)
+        .def_readwrite("vpin_buckets", &LOB::ToxicityConfig::vpinBuckets)
+        .def_readwrite("lambda_buckets", &LOB::ToxicityConfig::lambdaBuckets)
+        .def_readwrite("event_window", &LOB::ToxicityConfig::eventWindow)
+        .def_readwrite("levels", &LOB::ToxicityConfig::levels)
+        .def_readwrite("tick_size", &LOB::ToxicityConfig::tickSize);
+
+    py::class_<LOB::FlowToxicity>(m, "FlowToxicity")
+        .def(py::init<const LOB::ToxicityConfig&>(), py::arg("config") = LOB::ToxicityConfig{})
+        .def("on_event", &LOB::FlowToxicity::onEvent, "Update with a message already applied to the book and the book's new top")
+        .def("on_book_event", [](LOB::FlowToxicity& tox, const LOB::RAWMessage& msg, LOB::OrderBook& book) {
+                 book.apply(msg);
+                 tox.onEvent(msg, book.getTopOfBook());
+             }, "Apply a message to the book, then update the metrics")
+        .def_property_readonly("last_trade_sign", &LOB::FlowToxicity::lastTradeSign)
+        .def_property_readonly("buy_volume", &LOB::FlowToxicity::buyVolume)
+        .def_property_readonly("sell_volume", &LOB::FlowToxicity::sellVolume)
+        .def_property_readonly("trade_count", &LOB::FlowToxicity::tradeCount)
+        .def_property_readonly("vpin", &LOB::FlowToxicity::vpin)
+        .def_property_readonly("buckets_completed", &LOB::FlowToxicity::bucketsCompleted)
+        .def_property_readonly("kyle_lambda", &LOB::FlowToxicity::kyleLambda)
+        .def_property_readonly("levels", &LOB::FlowToxicity::levels)
+        .def("cancel_volume", &LOB::FlowToxicity::cancelVolume, py::arg("level"))
+        .def("trade_volume", &LOB::FlowToxicity::tradeVolume, py::arg("level"))
+        .def("cancel_to_trade_ratio", &LOB::FlowToxicity::cancelToTradeRatio, py::arg("level"))
+        .def("cancel_to_trade_ratios", [](const LOB::FlowToxicity& tox) {
+                 std::vector<double> ratios(tox.levels());
+                 for (size_t level = 0; level < ratios.size(); ++level) ratios[level] = tox.cancelToTradeRatio(level);
+                 return ratios;
+             }, "Cancel-to-trade ratio for every tracked level");
 }
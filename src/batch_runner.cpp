@@ -0,0 +1,236 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/Replay.h"
+#include "LOB/WorkStealingPool.h"
+
+// Batch replay of many (ticker, date) file pairs on one machine.
+//
+//   lob_batch <manifest> [--threads N] [--summary <path.csv>] [--scaling] [--capacity N]
+//
+// The manifest lists one job per line: "<message file> <orderbook file>"
+// (comma or whitespace separated, '#' starts a comment). Relative paths are
+// resolved against the manifest's directory; .gz/.zst inputs are fine.
+//
+// Jobs run largest-first on a work-stealing pool. Each worker owns a single
+// OrderBook that is reset between jobs, so its slab reserve and index are
+// allocated once per worker instead of once per file; growth past the reserve
+// comes from the shared block pool and is handed back on reset.
+//
+//   --threads N   Worker count (default: hardware concurrency)
+//   --summary     Per-job CSV (default: batch_summary.csv)
+//   --scaling     Also replay the whole manifest at 1, 2, 4, ... N workers and
+//                 print aggregate throughput / speedup per worker count
+//   --capacity N  Expected resting orders per book (default 1000000)
+
+namespace {
+
+struct Job {
+    std::string messagePath;
+    std::string orderbookPath;
+    uint64_t bytes = 0;
+};
+
+struct JobResult {
+    LOB::ReplayStats stats;
+    size_t worker = 0;
+    size_t bookBytes = 0; // book memory at the end of the job
+    std::string error;
+};
+
+std::vector<Job> readManifest(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Failed to open manifest: " + path);
+    const std::filesystem::path base = std::filesystem::path(path).parent_path();
+    auto resolve = [&](const std::string& p) {
+        std::filesystem::path fp(p);
+        return (fp.is_relative() ? base / fp : fp).string();
+    };
+
+    std::vector<Job> jobs;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        line = line.substr(0, line.find('#'));
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        std::string messages, orderbook;
+        if (!(fields >> messages)) continue; // blank / comment
+        if (!(fields >> orderbook)) {
+            throw std::runtime_error(path + ":" + std::to_string(lineNumber) + ": expected <messages> <orderbook>");
+        }
+        Job job{resolve(messages), resolve(orderbook)};
+        std::error_code ec;
+        job.bytes = std::filesystem::file_size(job.messagePath, ec);
+        if (ec) job.bytes = 0; // reported as a failed job later
+        jobs.push_back(job);
+    }
+    return jobs;
+}
+
+struct RunResult {
+    std::vector<JobResult> jobs;
+    LOB::WorkStealingStats pool;
+    double seconds = 0.0;
+    uint64_t messages = 0;
+};
+
+RunResult runBatch(const std::vector<Job>& jobs, const std::vector<size_t>& order, size_t threads, size_t capacity,
+                   std::vector<std::unique_ptr<LOB::OrderBook>>& books) {
+    RunResult run;
+    run.jobs.resize(jobs.size());
+
+    auto start = std::chrono::steady_clock::now();
+    run.pool = LOB::runWorkStealing(threads, order, [&](size_t worker, size_t j) {
+        // First job on this worker allocates its book (on its own thread); later ones reuse it
+        if (!books[worker]) {
+            books[worker] = std::make_unique<LOB::OrderBook>(capacity);
+        } else {
+            books[worker]->reset();
+        }
+        JobResult& result = run.jobs[j];
+        result.worker = worker;
+        try {
+            result.stats = LOB::replayVerified(*books[worker], jobs[j].messagePath, jobs[j].orderbookPath);
+        } catch (const std::exception& e) {
+            result.error = e.what();
+        }
+        result.bookBytes = books[worker]->memoryUsage().total();
+    });
+    run.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const auto& r : run.jobs) run.messages += r.stats.messages;
+    return run;
+}
+
+// RFC 4180 field: quoted, with embedded quotes doubled, if it holds a comma, quote or line break
+std::string csvField(const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) return value;
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
+
+void writeSummary(const std::string& path, const std::vector<Job>& jobs, const RunResult& run) {
+    std::ofstream out(path);
+    if (!out) throw std::runtime_error("Failed to open summary file: " + path);
+    out << "job,messages_file,orderbook_file,bytes,worker,messages,mismatches,heals,seconds,msgs_per_sec,book_bytes,status\n";
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const JobResult& r = run.jobs[j];
+        out << j << ',' << csvField(jobs[j].messagePath) << ',' << csvField(jobs[j].orderbookPath) << ',' << jobs[j].bytes << ','
+            << r.worker << ',' << r.stats.messages << ',' << r.stats.mismatches << ',' << r.stats.heals << ','
+            << r.stats.seconds << ',' << (r.stats.seconds > 0 ? r.stats.messages / r.stats.seconds : 0.0) << ',' << r.bookBytes << ','
+            << csvField(r.error.empty() ? "ok" : r.error) << '\n';
+    }
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::string manifestPath;
+    std::string summaryPath = "batch_summary.csv";
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    bool scaling = false;
+    size_t capacity = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            threads = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--summary" && i + 1 < argc) {
+            summaryPath = argv[++i];
+        } else if (arg == "--capacity" && i + 1 < argc) {
+            capacity = std::stoul(argv[++i]);
+        } else if (arg == "--scaling") {
+            scaling = true;
+        } else {
+            manifestPath = arg;
+        }
+    }
+    if (manifestPath.empty()) {
+        std::cerr << "Usage: lob_batch <manifest> [--threads N] [--summary <path.csv>] [--scaling] [--capacity N]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Job> jobs;
+    try {
+        jobs = readManifest(manifestPath);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    // Largest first: the long jobs start immediately instead of landing on the tail
+    std::vector<size_t> order(jobs.size());
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return jobs[a].bytes > jobs[b].bytes; });
+
+    std::cout << "Jobs: " << jobs.size() << ", workers: " << threads << std::endl;
+
+    std::vector<std::unique_ptr<LOB::OrderBook>> books(threads);
+
+    if (scaling) {
+        std::cout << std::setw(8) << "workers" << std::setw(12) << "wall_s" << std::setw(14) << "msgs/sec"
+                  << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << std::endl;
+        double base = 0.0;
+        std::vector<size_t> counts;
+        for (size_t n = 1; n < threads; n *= 2) counts.push_back(n);
+        counts.push_back(threads);
+        for (size_t n : counts) {
+            RunResult run = runBatch(jobs, order, n, capacity, books);
+            double rate = run.messages / run.seconds;
+            if (n == 1) base = rate;
+            std::cout << std::setw(8) << n << std::setw(12) << std::fixed << std::setprecision(3) << run.seconds
+                      << std::setw(14) << std::setprecision(0) << rate << std::setw(10) << std::setprecision(2)
+                      << rate / base << std::setw(12) << rate / base / n << std::endl;
+        }
+        std::cout << std::defaultfloat << std::setprecision(6) << std::endl;
+    }
+
+    RunResult run = runBatch(jobs, order, threads, capacity, books);
+
+    size_t failed = 0;
+    uint64_t mismatches = 0;
+    double busy = 0.0;
+    for (const auto& r : run.jobs) {
+        if (!r.error.empty()) failed++;
+        mismatches += r.stats.mismatches;
+        busy += r.stats.seconds;
+    }
+    size_t stolen = std::accumulate(run.pool.stolen.begin(), run.pool.stolen.end(), size_t(0));
+
+    try {
+        writeSummary(summaryPath, jobs, run);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Batch Complete." << std::endl;
+    std::cout << "Jobs: " << jobs.size() << " (" << failed << " failed, " << stolen << " stolen)" << std::endl;
+    std::cout << "Total Messages: " << run.messages << std::endl;
+    std::cout << "Logic Errors (Persistent): " << mismatches << std::endl;
+    std::cout << "Wall Time: " << run.seconds << "s" << std::endl;
+    std::cout << "Aggregate Throughput: " << run.messages / run.seconds << " msgs/sec" << std::endl;
+    std::cout << "Worker Utilization: " << 100.0 * busy / (run.seconds * threads) << "%" << std::endl;
+    std::cout << "Summary: " << summaryPath << std::endl;
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        if (!run.jobs[j].error.empty()) std::cerr << "FAILED " << jobs[j].messagePath << ": " << run.jobs[j].error << std::endl;
+    }
+
+    return failed == 0 ? 0 : 2;
+}
@@ -1,6 +1,59 @@
 #include <benchmark/benchmark.h>
 #include "LOB/OrderBook.h"
+#include "LOB/ConcurrentBookView.h"
+#include "LOB/ConsolidatedBook.h"
+#include "LOB/FeatureExporter.h"
+#include "LOB/FlowToxicity.h"
+#include "LOB/PerfCounters.h"
+#include <filesystem>
+#include <atomic>
+#include <iostream>
+#include <memory>
 #include <random>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Hardware counters for the timed loop, reported per iteration as user counters.
+// Construct right before `for (auto _ : state)`. When perf_event_open is not
+// usable (no PMU, paranoid setting, non-Linux) nothing is added.
+static LOB::PerfCounters& perfCounters() {
+    static LOB::PerfCounters counters;
+    return counters;
+}
+
+class PerfScope {
+public:
+    explicit PerfScope(benchmark::State& state) : state_(state) {
+        if (!perfCounters().available()) return;
+        perfCounters().start();
+        begin_ = perfCounters().read();
+    }
+
+    ~PerfScope() {
+        LOB::PerfCounters& counters = perfCounters();
+        if (!counters.available()) return;
+        LOB::PerfSample delta = counters.read() - begin_;
+        counters.stop();
+        for (size_t i = 0; i < LOB::kPerfEventCount; ++i) {
+            auto event = static_cast<LOB::PerfEvent>(i);
+            if (!counters.available(event)) continue;
+            state_.counters[LOB::perfEventName(event)] =
+                benchmark::Counter(delta.scaled(event), benchmark::Counter::kAvgIterations);
+        }
+        // Shared PMU: counts above are extrapolated from the fraction of time the group ran
+        if (delta.multiplexed()) {
+            state_.counters["pmu_running"] = delta.timeEnabled > 0 ? static_cast<double>(delta.timeRunning) / static_cast<double>(delta.timeEnabled) : 0.0;
+        }
+        if (counters.available(LOB::PerfEvent::Cycles) && counters.available(LOB::PerfEvent::Instructions) && delta[LOB::PerfEvent::Cycles] > 0) {
+            state_.counters["IPC"] = static_cast<double>(delta[LOB::PerfEvent::Instructions]) / static_cast<double>(delta[LOB::PerfEvent::Cycles]);
+        }
+    }
+
+private:
+    benchmark::State& state_;
+    LOB::PerfSample begin_;
+};
 
 // Fixture for setting up a book with some depth
 class OrderBookFixture : public benchmark::Fixture {
@@ -22,6 +75,7 @@ public:
 static void BM_AddOrder(benchmark::State& state) {
     LOB::OrderBook book;
     uint64_t id = 0;
+    PerfScope perf(state);
     for (auto _ : state) {
         book.addOrder(++id, 5000, 100, LOB::Side::Buy, 0);
     }
@@ -38,6 +92,7 @@ static void BM_ExecuteOrder(benchmark::State& state) {
     }
     
     uint64_t execID = 20000;
+    PerfScope perf(state);
     for (auto _ : state) {
         // Execute against the resting orders
         // Note: In a real bench we might reset state, but LOB performance often degrades with fragmentation, 
@@ -65,10 +120,305 @@ static void BM_GetOBI(benchmark::State& state) {
     book.addOrder(1, 100, 100, LOB::Side::Buy, 0);
     book.addOrder(2, 101, 100, LOB::Side::Sell, 0);
     
+    PerfScope perf(state);
     for (auto _ : state) {
         benchmark::DoNotOptimize(book.getOBI());
     }
 }
 BENCHMARK(BM_GetOBI);
 
-BENCHMARK_MAIN();
+// Writer throughput (add + cancel + publish) with N concurrent view readers spinning
+static void BM_PublishWithReaders(benchmark::State& state) {
+    LOB::OrderBook book;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        book.addOrder(i, 4000 + static_cast<LOB::Price>(i % 50), 100, LOB::Side::Buy, 0);
+        book.addOrder(i + 1000, 6000 + static_cast<LOB::Price>(i % 50), 100, LOB::Side::Sell, 0);
+    }
+
+    LOB::ConcurrentBookView<10> view;
+    view.publish(book);
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> readers;
+    for (int64_t r = 0; r < state.range(0); ++r) {
+        readers.emplace_back([&] {
+            double sink = 0.0;
+            while (!done.load(std::memory_order_relaxed)) {
+                sink += view.getMicroprice();
+                auto depth = view.getDepth();
+                sink += static_cast<double>(depth.bids[0].volume);
+            }
+            benchmark::DoNotOptimize(sink);
+        });
+    }
+
+    uint64_t id = 100000;
+    for (auto _ : state) {
+        ++id;
+        book.addOrder(id, 4050, 10, LOB::Side::Buy, 0);
+        view.publish(book);
+        book.cancelOrder(id);
+        view.publish(book);
+    }
+
+    done = true;
+    for (auto& t : readers) t.join();
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK(BM_PublishWithReaders)->Arg(0)->Arg(1)->Arg(8)->UseRealTime();
+
+// Book with state.range(0) ask levels (and as many bid levels) of 100 shares each
+static void fillLevels(LOB::OrderBook& book, int64_t levels) {
+    for (int64_t i = 0; i < levels; ++i) {
+        book.addOrder(static_cast<uint64_t>(i + 1), 10000 + i, 100, LOB::Side::Sell, 0);
+        book.addOrder(static_cast<uint64_t>(i + 1 + levels), 9999 - i, 100, LOB::Side::Buy, 0);
+    }
+}
+
+// Sweep VWAP for ~90% of the side's volume
+static void BM_SweepVWAP(benchmark::State& state) {
+    LOB::OrderBook book;
+    fillLevels(book, state.range(0));
+    LOB::Quantity size = static_cast<LOB::Quantity>(state.range(0)) * 90;
+    PerfScope perf(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.getSweepVWAP(LOB::Side::Sell, size));
+    }
+}
+BENCHMARK(BM_SweepVWAP)->Arg(10)->Arg(100)->Arg(1000);
+
+// Cumulative depth within a band covering all but the last level
+static void BM_DepthNearMid(benchmark::State& state) {
+    LOB::OrderBook book;
+    fillLevels(book, state.range(0));
+    LOB::Price band = state.range(0) - 1;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.getDepthNearMid(LOB::Side::Buy, band));
+    }
+}
+BENCHMARK(BM_DepthNearMid)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_PriceForSize(benchmark::State& state) {
+    LOB::OrderBook book;
+    fillLevels(book, state.range(0));
+    LOB::Quantity size = static_cast<LOB::Quantity>(state.range(0)) * 90;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(book.getPriceForSize(LOB::Side::Buy, size));
+    }
+}
+BENCHMARK(BM_PriceForSize)->Arg(10)->Arg(100)->Arg(1000);
+
+// Per-event cost of exporting the message + top-10 depth (all columns) through the async writer
+static void BM_ExportTop10(benchmark::State& state) {
+    LOB::OrderBook book;
+    fillLevels(book, 100);
+    auto dir = std::filesystem::temp_directory_path() / "lob_bench_export";
+    LOB::RAWMessage msg{34200.0, 1, 1, 100, 10000, -1};
+    {
+        LOB::FeatureExporter exporter(dir.string(), {}, 10);
+        for (auto _ : state) {
+            msg.timestamp += 1e-6;
+            exporter.record(msg, book);
+        }
+        exporter.close();
+    }
+    state.SetItemsProcessed(state.iterations());
+    std::filesystem::remove_all(dir);
+}
+BENCHMARK(BM_ExportTop10);
+
+// Replay throughput vs. batch size on a book too large for cache (1M resting orders).
+// The stream is cancel/re-add pairs of random resting orders, so every message is a
+// dependent chain of cache misses (index slot -> Order -> Limit). Batch size 1 is the
+// unpipelined baseline; larger batches let applyBatch prefetch ahead.
+template <typename Book>
+static std::vector<LOB::RAWMessage> fillForCancelReadd(Book& book) {
+    constexpr uint64_t kOrders = 1000000;
+    std::mt19937_64 rng(42);
+    std::vector<LOB::RAWMessage> resting(kOrders);
+    for (uint64_t i = 0; i < kOrders; ++i) {
+        int direction = (i & 1) ? 1 : -1;
+        int64_t price = direction == 1 ? 100000 - static_cast<int64_t>(rng() % 5000) : 100001 + static_cast<int64_t>(rng() % 5000);
+        resting[i] = LOB::RAWMessage{0.0, 1, i + 1, 100, price, direction};
+        book.apply(resting[i]);
+    }
+
+    std::vector<LOB::RAWMessage> stream;
+    stream.reserve(1 << 16);
+    while (stream.size() < (1 << 16)) {
+        LOB::RAWMessage add = resting[rng() % kOrders];
+        LOB::RAWMessage cancel = add;
+        cancel.type = 3;
+        stream.push_back(cancel);
+        stream.push_back(add);
+    }
+    return stream;
+}
+
+static void BM_ApplyBatch(benchmark::State& state) {
+    const size_t batch = static_cast<size_t>(state.range(0));
+
+    LOB::OrderBook book;
+    std::vector<LOB::RAWMessage> stream = fillForCancelReadd(book);
+
+    std::span<const LOB::RAWMessage> all(stream);
+    size_t pos = 0;
+    PerfScope perf(state);
+    for (auto _ : state) {
+        book.applyBatch(all.subspan(pos, batch));
+        pos += batch;
+        if (pos + batch > all.size()) pos = 0;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch));
+}
+BENCHMARK(BM_ApplyBatch)->Arg(1)->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+
+// Cost of the listener pack on the same cancel/re-add stream, one apply() per message:
+//   0: OrderBook (no listeners)
+//   1: BasicOrderBook<BookListener>, every callback left at its no-op default
+//   2: a listener implementing every callback (counters)
+// 0 and 1 should be indistinguishable: unused callbacks compile to nothing.
+struct CountingListener : LOB::BookListener {
+    uint64_t added = 0, reduced = 0, removed = 0, levels = 0, touches = 0, tops = 0;
+    void onOrderAdded(const LOB::Order&) { added++; }
+    void onOrderReduced(const LOB::Order&, LOB::Quantity) { reduced++; }
+    void onOrderRemoved(const LOB::Order&) { removed++; }
+    void onLevelCreated(LOB::Side, LOB::Price) { levels++; }
+    void onLevelRemoved(LOB::Side, LOB::Price) { levels--; }
+    void onBestPriceChanged(LOB::Side, LOB::Price) { touches++; }
+    void onTopOfBookChanged(const LOB::TopOfBook&) { tops++; }
+};
+
+template <typename Book>
+static void applyEach(benchmark::State& state) {
+    auto book = std::make_unique<Book>();
+    std::vector<LOB::RAWMessage> stream = fillForCancelReadd(*book);
+    size_t pos = 0;
+    PerfScope perf(state);
+    for (auto _ : state) {
+        book->apply(stream[pos]);
+        if (++pos == stream.size()) pos = 0;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+static void BM_ApplyListeners(benchmark::State& state) {
+    switch (state.range(0)) {
+        case 0: applyEach<LOB::OrderBook>(state); break;
+        case 1: applyEach<LOB::BasicOrderBook<LOB::BookListener>>(state); break;
+        default: applyEach<LOB::BasicOrderBook<CountingListener>>(state); break;
+    }
+}
+BENCHMARK(BM_ApplyListeners)->Arg(0)->Arg(1)->Arg(2);
+
+// Consolidated BBO maintenance per venue quote update, 2-16 venues.
+// Each venue's touch random-walks: mostly size changes at the same price, some
+// one-tick moves, a few sides pulled and restored, which is roughly how venue
+// feeds look. Compared against rescanning every venue's cached touch (the cost
+// floor of calling getBestBid/getBestAsk on each book after every message).
+static std::vector<std::pair<size_t, LOB::TopOfBook>> venueQuoteStream(size_t venues) {
+    std::mt19937_64 rng(17);
+    std::vector<LOB::TopOfBook> tops(venues);
+    for (size_t v = 0; v < venues; ++v) {
+        tops[v] = {10000 - static_cast<int64_t>(v % 3), 100, 10001 + static_cast<int64_t>(v % 3), 100};
+    }
+    std::vector<std::pair<size_t, LOB::TopOfBook>> stream(1 << 16);
+    for (auto& [v, top] : stream) {
+        v = rng() % venues;
+        LOB::TopOfBook& t = tops[v];
+        const bool bid = rng() & 1;
+        LOB::Price& price = bid ? t.bidPrice : t.askPrice;
+        LOB::Quantity& size = bid ? t.bidSize : t.askSize;
+        switch (rng() % 10) {
+            case 0: // tick away (or restore a pulled side)
+                price = price == LOB::INVALID_PRICE ? (bid ? 9998 : 10003) : price + (bid ? -1 : 1);
+                size = 100;
+                break;
+            case 1: // tick in, without crossing
+                if (price != LOB::INVALID_PRICE && (bid ? price < 9999 + (t.askPrice == LOB::INVALID_PRICE ? 2 : 0) : price > 10002)) {
+                    price += bid ? 1 : -1;
+                }
+                break;
+            case 2:
+                if (rng() % 8 == 0) { price = LOB::INVALID_PRICE; size = 0; break; }
+                [[fallthrough]];
+            default: // size change at the touch
+                if (price != LOB::INVALID_PRICE) size = 100 * (1 + rng() % 5);
+                break;
+        }
+        top = t;
+    }
+    return stream;
+}
+
+static void BM_ConsolidatedUpdate(benchmark::State& state) {
+    const size_t venues = static_cast<size_t>(state.range(0));
+    auto stream = venueQuoteStream(venues);
+    LOB::ConsolidatedBook<16> nbbo(venues);
+    size_t i = 0;
+    uint64_t emitted = 0;
+    PerfScope perf(state);
+    for (auto _ : state) {
+        const auto& [v, top] = stream[i++ & (stream.size() - 1)];
+        emitted += nbbo.update(v, top);
+    }
+    benchmark::DoNotOptimize(emitted);
+    state.counters["emit_ratio"] = static_cast<double>(emitted) / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_ConsolidatedUpdate)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+static void BM_ConsolidatedRescan(benchmark::State& state) {
+    const size_t venues = static_cast<size_t>(state.range(0));
+    auto stream = venueQuoteStream(venues);
+    std::vector<LOB::TopOfBook> tops(venues);
+    size_t i = 0;
+    PerfScope perf(state);
+    for (auto _ : state) {
+        const auto& [v, top] = stream[i++ & (stream.size() - 1)];
+        tops[v] = top;
+        LOB::ConsolidatedQuote q;
+        for (size_t k = 0; k < venues; ++k) {
+            const LOB::TopOfBook& t = tops[k];
+            if (t.bidPrice > q.bidPrice) { q.bidPrice = t.bidPrice; q.bidSize = 0; q.bidVenues = 0; }
+            if (t.bidPrice == q.bidPrice && t.bidPrice != LOB::INVALID_PRICE) { q.bidSize += t.bidSize; q.bidVenues |= uint64_t(1) << k; }
+            if (t.askPrice == LOB::INVALID_PRICE) continue;
+            if (q.askPrice == LOB::INVALID_PRICE || t.askPrice < q.askPrice) { q.askPrice = t.askPrice; q.askSize = 0; q.askVenues = 0; }
+            if (t.askPrice == q.askPrice) { q.askSize += t.askSize; q.askVenues |= uint64_t(1) << k; }
+        }
+        benchmark::DoNotOptimize(q);
+    }
+}
+BENCHMARK(BM_ConsolidatedRescan)->Arg(2)->Arg(4)->Arg(8)->Arg(16);
+
+// Per-event cost of the toxicity analytics (signing, VPIN, lambda, per-level cancels)
+static void BM_FlowToxicity(benchmark::State& state) {
+    std::mt19937_64 rng(23);
+    std::vector<LOB::RAWMessage> stream(1 << 16);
+    for (auto& msg : stream) {
+        msg = LOB::RAWMessage{34200.0, 1 + static_cast<int>(rng() % 5), rng(), 1 + rng() % 500,
+                              10000 + static_cast<int64_t>(rng() % 2000) - 1000, (rng() & 1) ? 1 : -1};
+    }
+    LOB::TopOfBook top{9900, 300, 10100, 300};
+    LOB::ToxicityConfig config;
+    config.bucketVolume = 5000;
+    LOB::FlowToxicity tox(config);
+    size_t i = 0;
+    PerfScope perf(state);
+    for (auto _ : state) {
+        tox.onEvent(stream[i++ & (stream.size() - 1)], top);
+    }
+    benchmark::DoNotOptimize(tox.vpin());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_FlowToxicity);
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    if (!perfCounters().available()) {
+        std::cerr << "Hardware counters unavailable (" << perfCounters().error() << "); reporting wall time only" << std::endl;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
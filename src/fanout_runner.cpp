@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LOB/FanOutReplay.h"
+#include "LOB/OrderBook.h"
+#include "LOB/Replay.h"
+#include "LOB/WorkStealingPool.h"
+
+// Parameter sweep over one LOBSTER day with a single parse (fan-out replay).
+//
+//   lob_fanout <messages> <orderbook> [--strategies M] [--workers W]
+//              [--mode free|lockstep] [--window N] [--ring N] [--compare]
+//
+// Runs M instances of a toy order-book-imbalance strategy, one threshold each,
+// spread over W worker threads. The day is parsed and applied to one
+// reference book; every worker reads the published events from the shared
+// ring (see FanOutReplay.h).
+//
+//   --strategies M  Sweep size (default 64); thresholds evenly spaced in (0, 1)
+//   --workers W     Consumer threads (default: hardware concurrency - 1, at least 1)
+//   --mode          free (default) or lockstep
+//   --window N      Lockstep: max events a worker may run ahead of the slowest (default 1024)
+//   --ring N        Ring capacity in events (default 65536)
+//   --compare       Also run the sweep the old way (each instance replays the day
+//                   itself, on a work-stealing pool of W threads), check the
+//                   results agree and print the speedup
+
+namespace {
+
+// Holds +1 / -1 / 0 units depending on top-of-book imbalance vs a threshold,
+// crossing the spread to trade. Marked to mid.
+struct ImbalanceStrategy {
+    double threshold = 0.5;
+    int64_t position = 0;
+    double cash = 0.0;
+    double mid = 0.0;
+    uint64_t trades = 0;
+
+    void onTop(const LOB::TopOfBook& top) {
+        if (top.bidPrice == LOB::INVALID_PRICE || top.askPrice == LOB::INVALID_PRICE) return;
+        mid = 0.5 * (static_cast<double>(top.bidPrice) + static_cast<double>(top.askPrice));
+        const double obi = top.obi();
+        const int64_t target = obi > threshold ? 1 : obi < -threshold ? -1 : 0;
+        if (target == position) return;
+        const int64_t qty = target - position;
+        cash -= static_cast<double>(qty) * static_cast<double>(qty > 0 ? top.askPrice : top.bidPrice);
+        position = target;
+        trades++;
+    }
+
+    double pnl() const { return cash + static_cast<double>(position) * mid; }
+};
+
+std::vector<ImbalanceStrategy> makeSweep(size_t count) {
+    std::vector<ImbalanceStrategy> sweep(count);
+    for (size_t i = 0; i < count; ++i) sweep[i].threshold = (static_cast<double>(i) + 0.5) / static_cast<double>(count);
+    return sweep;
+}
+
+struct StrategyHooks : LOB::ReplayHooks {
+    ImbalanceStrategy* strategy;
+    void afterMessage(const LOB::RAWMessage&, const LOB::OrderBook& book, uint64_t) { strategy->onTop(book.getTopOfBook()); }
+};
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    size_t strategies = 64;
+    size_t workers = std::max(1u, std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 1u);
+    bool compare = false;
+    LOB::FanOutConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--strategies" && i + 1 < argc) {
+            strategies = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--workers" && i + 1 < argc) {
+            workers = std::max<size_t>(1, std::stoul(argv[++i]));
+        } else if (arg == "--mode" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            config.mode = mode == "lockstep" ? LOB::FanOutMode::Lockstep : LOB::FanOutMode::FreeRunning;
+        } else if (arg == "--window" && i + 1 < argc) {
+            config.lockstepWindow = std::stoul(argv[++i]);
+        } else if (arg == "--ring" && i + 1 < argc) {
+            config.ringCapacity = std::stoul(argv[++i]);
+        } else if (arg == "--compare") {
+            compare = true;
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        std::cerr << "Usage: lob_fanout <messages> <orderbook> [--strategies M] [--workers W] "
+                     "[--mode free|lockstep] [--window N] [--ring N] [--compare]" << std::endl;
+        return 1;
+    }
+    const std::string& msgPath = positional[0];
+    const std::string& bookPath = positional[1];
+    workers = std::min(workers, strategies);
+
+    // Worker w runs instances w, w + W, w + 2W, ...
+    std::vector<ImbalanceStrategy> sweep = makeSweep(strategies);
+    LOB::FanOutStats stats;
+    try {
+        stats = LOB::runFanOut(msgPath, bookPath, workers, [&](size_t w, std::span<const LOB::FanOutEvent> events) {
+            for (size_t s = w; s < sweep.size(); s += workers) {
+                ImbalanceStrategy& strategy = sweep[s];
+                for (const LOB::FanOutEvent& event : events) strategy.onTop(event.top);
+            }
+        }, config);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    const uint64_t workerStalls = std::accumulate(stats.workerStalls.begin(), stats.workerStalls.end(), uint64_t(0));
+    auto best = std::max_element(sweep.begin(), sweep.end(), [](const auto& a, const auto& b) { return a.pnl() < b.pnl(); });
+    std::cout << "Fan-out Complete (" << (config.mode == LOB::FanOutMode::Lockstep ? "lockstep" : "free-running") << ")." << std::endl;
+    std::cout << "Events: " << stats.events << ", logic errors: " << stats.replay.mismatches << std::endl;
+    std::cout << "Strategies: " << strategies << " on " << workers << " workers" << std::endl;
+    std::cout << "Wall Time: " << stats.seconds << "s" << std::endl;
+    std::cout << "Strategy-Events/sec: " << static_cast<double>(stats.events) * strategies / stats.seconds << std::endl;
+    std::cout << "Stalls: producer " << stats.producerStalls << ", workers " << workerStalls << std::endl;
+    std::cout << "Best threshold: " << best->threshold << " (pnl " << best->pnl() << ", " << best->trades << " trades)" << std::endl;
+
+    if (compare) {
+        std::vector<ImbalanceStrategy> naive = makeSweep(strategies);
+        std::vector<size_t> jobs(strategies);
+        std::iota(jobs.begin(), jobs.end(), size_t(0));
+        auto start = std::chrono::steady_clock::now();
+        try {
+            LOB::runWorkStealing(workers, jobs, [&](size_t, size_t s) {
+                LOB::OrderBook book(config.expectedOrders);
+                StrategyHooks hooks;
+                hooks.strategy = &naive[s];
+                LOB::replayVerified(book, msgPath, bookPath, hooks);
+            });
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        double naiveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t differing = 0;
+        for (size_t s = 0; s < strategies; ++s) {
+            if (naive[s].trades != sweep[s].trades || naive[s].pnl() != sweep[s].pnl()) differing++;
+        }
+        std::cout << "Independent Replays: " << naiveSeconds << "s (" << std::fixed << std::setprecision(2)
+                  << naiveSeconds / stats.seconds << "x slower)" << std::defaultfloat << std::setprecision(6) << std::endl;
+        std::cout << "Results Match: " << (differing == 0 ? "yes" : "NO (" + std::to_string(differing) + " differ)") << std::endl;
+        if (differing != 0) return 2;
+    }
+    return 0;
+}
@@ -3,47 +3,16 @@
 #include <iomanip>
 #include <cmath>
 #include <chrono> // Added missing include
+#include <string>
+#include <sstream>
 #include "LOB/OrderBook.h"
-#include "LOB/CSVParser.h"
-
-struct LOBTruthLevel {
-    LOB::Price askPrice;
-    LOB::Quantity askSize;
-    LOB::Price bidPrice;
-    LOB::Quantity bidSize;
-};
-
-// Returns a vector of 10 levels
-std::vector<LOBTruthLevel> parseTruthLine(const char*& current, const char* end) {
-    std::vector<LOBTruthLevel> levels;
-    levels.reserve(10);
-
-    for (int i = 0; i < 10; ++i) {
-        if (current >= end) break;
-        LOBTruthLevel lvl;
-        
-        char* nextToken;
-        // Ask Price
-        lvl.askPrice = std::strtoll(current, &nextToken, 10);
-        current = nextToken + 1;
-        // Ask Size
-        lvl.askSize = std::strtoull(current, &nextToken, 10);
-        current = nextToken + 1;
-        // Bid Price
-        lvl.bidPrice = std::strtoll(current, &nextToken, 10);
-        current = nextToken + 1;
-        // Bid Size
-        lvl.bidSize = std::strtoull(current, &nextToken, 10);
-        current = nextToken + 1; // Skip comma or newline
-
-        levels.push_back(lvl);
-    }
-    // Skip newline
-    if (current < end && (*current == '\n' || *current == '\r')) current++;
-    if (current < end && *current == '\n') current++; // Handle CRLF
-
-    return levels;
-}
+#include "LOB/Replay.h"
+#include "LOB/Resampler.h"
+#include "LOB/FeatureExporter.h"
+#include "LOB/FlowToxicity.h"
+#include "LOB/PerfCounters.h"
+#include <array>
+#include <memory>
 
 int main(int argc, char* argv[]) {
     // Relative paths assume running from the 'build' directory (project root is ..)
@@ -54,192 +23,219 @@ int main(int argc, char* argv[]) {
     // Fallback: search in current dir if not found in ..
     // (Simple check omitted for brevity, assuming standard build folder structure)
 
+    // Options:
+    //   --resample 0.1,1   Aggregate bars for each bucket width (seconds) during replay
+    //   --export <dir>     Write per-event message + book columns (.npy) to <dir>/events,
+    //                      and resampled bars to <dir>/bars_<width>s
+    //   --columns a,b,...  Export only these columns (default: all, see FeatureExporter)
+    //   --depth N          Book levels available for export (default 10)
+    //   --messages <path>  LOBSTER message file (.csv, .csv.gz or .csv.zst)
+    //   --orderbook <path> LOBSTER orderbook file (.csv, .csv.gz or .csv.zst)
+    //   --profile          Per-message-type time and hardware counter totals for book updates
+    //   --toxicity         Live trade signing / VPIN / Kyle's lambda / cancel-to-trade (summary at end)
+    std::vector<double> resampleWidths;
+    std::string exportDir;
+    std::vector<std::string> exportColumns;
+    size_t exportDepth = 10;
+    bool profile = false;
+    bool toxicity = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--resample" && i + 1 < argc) {
+            std::stringstream widths(argv[++i]);
+            std::string width;
+            while (std::getline(widths, width, ',')) {
+                resampleWidths.push_back(std::stod(width));
+            }
+        } else if (arg == "--export" && i + 1 < argc) {
+            exportDir = argv[++i];
+        } else if (arg == "--columns" && i + 1 < argc) {
+            std::stringstream names(argv[++i]);
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                exportColumns.push_back(name);
+            }
+        } else if (arg == "--depth" && i + 1 < argc) {
+            exportDepth = std::stoul(argv[++i]);
+        } else if (arg == "--messages" && i + 1 < argc) {
+            msgPath = argv[++i];
+        } else if (arg == "--orderbook" && i + 1 < argc) {
+            bookPath = argv[++i];
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--toxicity") {
+            toxicity = true;
+        }
+    }
+    // Bars are counted, and written under --export, as they close
+    std::vector<uint64_t> barCounts(resampleWidths.size(), 0);
+    std::vector<std::unique_ptr<LOB::BarWriter>> barWriters;
+    std::unique_ptr<LOB::Resampler> resamplerOwner;
+    try {
+        resamplerOwner = std::make_unique<LOB::Resampler>(resampleWidths, [&](size_t w, const LOB::Bar& bar) {
+            barCounts[w]++;
+            if (!barWriters.empty()) barWriters[w]->write(bar);
+        });
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    LOB::Resampler& resampler = *resamplerOwner;
+    if (!exportDir.empty()) {
+        for (size_t w = 0; w < resampler.widthCount(); ++w) {
+            std::ostringstream dir;
+            dir << exportDir << "/bars_" << resampler.widthSeconds(w) << "s";
+            barWriters.push_back(std::make_unique<LOB::BarWriter>(dir.str()));
+        }
+    }
+    // Profiling: LOBSTER types 1..7, index 0 collects anything else
+    struct TypeProfile {
+        uint64_t count = 0;
+        uint64_t nanos = 0;
+        LOB::PerfSample counters;
+    };
+    std::array<TypeProfile, 8> typeProfile{};
+    std::unique_ptr<LOB::PerfCounters> perf;
+    if (profile) {
+        perf = std::make_unique<LOB::PerfCounters>();
+        if (!perf->available()) {
+            std::cout << "Hardware counters unavailable (" << perf->error() << "); profiling wall time only" << std::endl;
+        }
+        perf->start();
+    }
+    std::unique_ptr<LOB::FlowToxicity> flow;
+    if (toxicity) {
+        flow = std::make_unique<LOB::FlowToxicity>();
+    }
+    std::unique_ptr<LOB::FeatureExporter> exporter;
+    if (!exportDir.empty()) {
+        exporter = std::make_unique<LOB::FeatureExporter>(exportDir + "/events", exportColumns, exportDepth);
+    }
+
     std::cout << "Initializing LOBSTER Simulation..." << std::endl;
     std::cout << "Message File: " << msgPath << std::endl;
     std::cout << "Orderbook File: " << bookPath << std::endl;
 
     LOB::OrderBook book;
-    
-    // Ensure files exist before starting specific parser
-    // We assume they open successfully or throw
-    LOB::LobsterMessageParser msgParser(msgPath);
-    LOB::MemoryMappedFile truthFile(bookPath);
-    const char* truthCurrent = truthFile.data();
-    const char* truthEnd = truthFile.data() + truthFile.size();
 
-    uint64_t msgCount = 0;
-    uint64_t errorCount = 0;
-    LOB::RAWMessage msg;
+    struct MainHooks : LOB::ReplayHooks {
+        bool profile;
+        LOB::PerfCounters* perf;
+        std::array<TypeProfile, 8>& typeProfile;
+        LOB::Resampler& resampler;
+        LOB::FeatureExporter* exporter;
+        LOB::FlowToxicity* flow;
+        std::chrono::steady_clock::time_point profileStart{};
+        LOB::PerfSample perfStart{};
+
+        void beforeApply(const LOB::RAWMessage&) {
+            if (profile) {
+                perfStart = perf->read();
+                profileStart = std::chrono::steady_clock::now();
+            }
+        }
 
-    auto timeStart = std::chrono::high_resolution_clock::now();
+        void afterApply(const LOB::RAWMessage& msg) {
+            if (!profile) return;
+            auto profileEnd = std::chrono::steady_clock::now();
+            TypeProfile& slot = typeProfile[(msg.type >= 1 && msg.type <= 7) ? msg.type : 0];
+            slot.counters += perf->read() - perfStart;
+            slot.nanos += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(profileEnd - profileStart).count());
+            slot.count++;
+        }
 
-    // --- Initialization Phase ---
-    // Read the first line of the truth file to initialize the book
-    // This represents the state AFTER the first message?
-    // Wait, if we assume the first message is an UPDATE, we need the state BEFORE it.
-    // LOBSTER strategy: usually we just start from the snapshot.
-    // Let's try: Initialize with Truth Line 1, then SKIP Msg 1. Start verifying from Msg 2.
-    
-    auto truthLevelsInit = parseTruthLine(truthCurrent, truthEnd);
-    if (truthLevelsInit.empty()) {
-        std::cerr << "Empty truth file!" << std::endl;
+        void afterMessage(const LOB::RAWMessage& msg, const LOB::OrderBook& book, uint64_t msgCount) {
+            // Debug Tracing
+            if (msg.orderId == 13419503 || msg.price == 5854000) {
+                std::cout << "[DEBUG] Msg " << msgCount << " Type " << msg.type
+                          << " ID " << msg.orderId << " Size " << msg.size
+                          << " Price " << msg.price << " Dir " << msg.direction << std::endl;
+            }
+            if (resampler.widthCount() > 0) {
+                resampler.onEvent(msg, book.getTopOfBook());
+            }
+            if (exporter) {
+                exporter->record(msg, book);
+            }
+            if (flow) {
+                flow->onEvent(msg, book.getTopOfBook());
+            }
+            if (msgCount % 100000 == 0) {
+                std::cout << "Processed " << msgCount << " messages." << std::endl;
+            }
+        }
+    };
+
+    LOB::ReplayStats stats;
+    try {
+        stats = LOB::replayVerified(book, msgPath, bookPath,
+                                    MainHooks{{}, profile, perf.get(), typeProfile, resampler, exporter.get(), flow.get()},
+                                    &std::cerr);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
         return 1;
     }
-    
-    // Populate Book
-    for (const auto& level : truthLevelsInit) {
-        if (level.askPrice != -9999999999) 
-            book.addLevel(level.askPrice, level.askSize, LOB::Side::Sell);
-        if (level.bidPrice != -9999999999) 
-            book.addLevel(level.bidPrice, level.bidSize, LOB::Side::Buy);
+
+    std::cout << "Simulation Complete." << std::endl;
+    std::cout << "Total Messages: " << stats.messages << std::endl;
+    std::cout << "Logic Errors (Persistent): " << stats.mismatches << std::endl;
+    std::cout << "Healed Levels: " << stats.heals << std::endl;
+    std::cout << "Book Memory: " << book.memoryUsage().total() / (1024 * 1024) << " MiB" << std::endl;
+    std::cout << "Time: " << stats.seconds << "s" << std::endl;
+    std::cout << "Throughput: " << stats.messages / stats.seconds << " msgs/sec" << std::endl;
+
+    resampler.flush();
+    for (size_t w = 0; w < resampler.widthCount(); ++w) {
+        std::cout << "Bars (" << resampler.widthSeconds(w) << "s): " << barCounts[w] << std::endl;
     }
-    
-    // consume Msg 1 (Skip it)
-    if (!msgParser.next(msg)) {
-         std::cout << "No messages!" << std::endl;
-         return 0;
+    try {
+        for (auto& writer : barWriters) writer->close();
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
     }
-    msgCount++; // Count it as processed (or skipped)
-    
-    // --- Simulation Phase ---
-
-    while (msgParser.next(msg)) {
-        msgCount++;
-
-        // Process Message
-        // Debug Tracing
-        if (msg.orderId == 13419503 || msg.price == 5854000) {
-            std::cout << "[DEBUG] Msg " << msgCount << " Type " << msg.type 
-                      << " ID " << msg.orderId << " Size " << msg.size 
-                      << " Price " << msg.price << " Dir " << msg.direction << std::endl;
-        }
-
-        // Pass Price/Side/Size for fallback handling
-        LOB::Side side = (msg.direction == 1 ? LOB::Side::Buy : LOB::Side::Sell);
-
-        switch (msg.type) {
-            case 1: // Add
-                book.addOrder(msg.orderId, msg.price, msg.size, side, 
-                              static_cast<uint64_t>(msg.timestamp * 1e9));
-                break;
-            case 2: // Partial Cancel
-                book.reduceOrder(msg.orderId, msg.size, msg.price, side);
-                break;
-            case 3: // Delete
-                book.deleteOrder(msg.orderId, msg.price, msg.size, side);
-                break;
-            case 4: // Execution
-                book.executeOrder(msg.orderId, msg.size, msg.price, side);
-                break;
-            case 5: // Hidden Exec - Ignore
-                break;
-            default:
-                break;
+    if (profile) {
+        perf->stop();
+        std::cout << "\nProfile (book update only, per message):" << std::endl;
+        std::cout << std::setw(6) << "type" << std::setw(12) << "count" << std::setw(10) << "ns";
+        for (size_t e = 0; e < LOB::kPerfEventCount; ++e) {
+            if (perf->available(static_cast<LOB::PerfEvent>(e))) std::cout << std::setw(15) << LOB::perfEventName(static_cast<LOB::PerfEvent>(e));
         }
-
-        // Verification
-        // We consumed Msg N. We need Truth N.
-        // We initiated with Truth 1 (corresponding to Msg 1).
-        // Now we processed Msg 2. So we need Truth 2.
-        auto truthLevels = parseTruthLine(truthCurrent, truthEnd);
-        
-        if (!truthLevels.empty()) {
-            auto truth = truthLevels[0];
-            
-                // Helper to check if we have the level
-                auto healLevel = [&](LOB::Price tPrice, LOB::Quantity tSize, LOB::Side side) {
-                     // We need to inject a real order so that executions can happen against it.
-                     // Use a high dummy ID to avoid collision
-                     static uint64_t dummyId = 9000000000ULL; 
-                     
-                     // Use the public addOrder. 
-                     // NOTE: This adds to the TAIL. For a new level, it's the only order.
-                     // If the level exists but size is wrong, we might want to wipe it first?
-                     // For now, assume Missing Level case (vol 0).
-                     
-                     LOB::Limit* limit = book.getOrCreateLimit(tPrice, side);
-                     if (limit->totalVolume != tSize) {
-                         // Reset level: Remove all existing orders (if any) to force sync
-                         // Doing precise diff is hard. Clearing is safer for "Healing".
-                         // Note: We don't have a specific `clearLimit` but we can just
-                         // manually reset it if we trust the Truth 100%.
-                         // Actually, let's just use addOrder logic which is cleaner.
-                         
-                         // Simple approach: Use Force Healing if missing.
-                         if (limit->totalVolume == 0) {
-                             dummyId++;
-                             book.addOrder(dummyId, tPrice, tSize, side, 0);
-                         } else {
-                             // Volume Mismatch. 
-                             // Adjusting is hard because we don't know WHICH order causes it.
-                             // But we need to make totalVolume == tSize.
-                             // We can add/cancel a "Correction" order.
-                             int64_t diff = (int64_t)tSize - (int64_t)limit->totalVolume;
-                             dummyId++;
-                             if (diff > 0) {
-                                 book.addOrder(dummyId, tPrice, (uint64_t)diff, side, 0);
-                             } else if (diff < 0) {
-                                 // Reduce volume? 
-                                 // We can't easily reduce without an ID map for the specific dummy.
-                                 // Just force set volume? No, list must match.
-                                 // Reduce from Head?
-                                 book.executeOrder(0, (uint64_t)(-diff), tPrice, side);
-                             }
-                         }
-                     }
-                };
-                
-                auto checkAsk = [&](LOB::Price tPrice, LOB::Quantity tSize) {
-                    if (tPrice == -9999999999) return;
-                    LOB::Quantity myVol = book.getVolumeAtPrice(tPrice);
-                    
-                    if (myVol != tSize) {
-                        bool missing = (myVol == 0);
-                        if (!missing && errorCount < 10) {
-                             std::cerr << "Mismatch at msg " << msgCount << " (ASK " << tPrice << "): "
-                                       << "Exp " << tSize << ", Got " << myVol << std::endl;
-                             errorCount++;
-                        }
-                        // Always Heal
-                        healLevel(tPrice, tSize, LOB::Side::Sell);
-                    }
-                };
-                
-                auto checkBid = [&](LOB::Price tPrice, LOB::Quantity tSize) {
-                     if (tPrice == -9999999999) return;
-                     LOB::Quantity myVol = book.getVolumeAtPrice(tPrice);
-                     
-                     if (myVol != tSize) {
-                        bool missing = (myVol == 0);
-                        if (!missing && errorCount < 10) {
-                             std::cerr << "Mismatch at msg " << msgCount << " (BID " << tPrice << "): "
-                                       << "Exp " << tSize << ", Got " << myVol << std::endl;
-                             errorCount++;
-                        }
-                        // Always Heal
-                        healLevel(tPrice, tSize, LOB::Side::Buy);
-                     }
-                };
-                
-                // Validate Best Ask
-                checkAsk(truth.askPrice, truth.askSize);
-                // Validate Best Bid
-                checkBid(truth.bidPrice, truth.bidSize);
+        std::cout << std::endl;
+        for (size_t t = 0; t < typeProfile.size(); ++t) {
+            const TypeProfile& slot = typeProfile[t];
+            if (slot.count == 0) continue;
+            double n = static_cast<double>(slot.count);
+            std::cout << std::setw(6) << (t == 0 ? std::string("other") : std::to_string(t)) << std::setw(12) << slot.count
+                      << std::setw(10) << std::fixed << std::setprecision(1) << slot.nanos / n;
+            for (size_t e = 0; e < LOB::kPerfEventCount; ++e) {
+                auto event = static_cast<LOB::PerfEvent>(e);
+                if (perf->available(event)) std::cout << std::setw(15) << slot.counters.scaled(event) / n;
             }
-        
-        if (msgCount % 100000 == 0) {
-            std::cout << "Processed " << msgCount << " messages." << std::endl;
+            std::cout << std::endl;
+        }
+        LOB::PerfSample total;
+        for (const TypeProfile& slot : typeProfile) total += slot.counters;
+        if (perf->available() && total.multiplexed()) {
+            std::cout << "Counters were multiplexed (on the PMU " << std::setprecision(1)
+                      << (total.timeEnabled ? 100.0 * static_cast<double>(total.timeRunning) / static_cast<double>(total.timeEnabled) : 0.0)
+                      << "% of the time); counts are scaled estimates" << std::endl;
         }
+        std::cout.unsetf(std::ios::fixed);
+    }
+    if (flow) {
+        std::cout << "\nFlow toxicity (bucket " << flow->config().bucketVolume << " shares):" << std::endl;
+        std::cout << "Trades: " << flow->tradeCount() << " (buy " << flow->buyVolume() << ", sell " << flow->sellVolume() << " shares)" << std::endl;
+        std::cout << "VPIN (last " << flow->config().vpinBuckets << " buckets of " << flow->bucketsCompleted() << "): " << flow->vpin() << std::endl;
+        std::cout << "Kyle's lambda: " << flow->kyleLambda() << " price units/share" << std::endl;
+        std::cout << "Cancel-to-trade by level (last " << flow->config().eventWindow << " events):";
+        for (size_t level = 0; level < flow->levels(); ++level) std::cout << ' ' << flow->cancelToTradeRatio(level);
+        std::cout << std::endl;
+    }
+    if (exporter) {
+        exporter->close();
+        std::cout << "Exported " << exporter->rows() << " rows to " << exportDir << "/events" << std::endl;
     }
-
-    auto timeEnd = std::chrono::high_resolution_clock::now();
-    std::chrono::duration<double> distinct = timeEnd - timeStart;
-
-    std::cout << "Simulation Complete." << std::endl;
-    std::cout << "Total Messages: " << msgCount << std::endl;
-    std::cout << "Logic Errors (Persistent): " << errorCount << std::endl;
-    std::cout << "Time: " << distinct.count() << "s" << std::endl;
-    std::cout << "Throughput: " << msgCount / distinct.count() << " msgs/sec" << std::endl;
 
     return 0;
 }
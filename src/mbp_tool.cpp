@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/Replay.h"
+#include "LOB/MbpCodec.h"
+
+// Market-by-price feed for a LOBSTER day, compared with the orderbook CSV.
+//
+//   lob_mbp <messages> <orderbook> [--out <file.mbp>] [--keyframe N]
+//
+// Replays the day (verified, as lob_sim) and encodes the top 10 levels after
+// every message as an MBP delta stream (see MbpCodec.h). Then reports:
+//   size    MBP bytes vs the orderbook CSV (decompressed bytes for .gz/.zst)
+//   decode  rebuilding the depth-10 book from MBP vs parsing every CSV row
+// and checks that the decoded book at the end equals the replayed one.
+//
+//   --out       Also write the MBP stream to a file
+//   --keyframe  Frames between keyframes (default 1024)
+
+namespace {
+
+constexpr size_t kDepth = 10;
+
+struct EncodeHooks : LOB::ReplayHooks {
+    LOB::MbpEncoder<kDepth>* encoder;
+    std::vector<uint8_t>* out;
+
+    void afterMessage(const LOB::RAWMessage& msg, const LOB::OrderBook& book, uint64_t) {
+        encoder->encode(book, msg.timestamp, *out);
+    }
+};
+
+template <typename F>
+double bestOfSeconds(int runs, F&& body) {
+    double best = 1e300;
+    for (int r = 0; r < runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    std::string outPath;
+    size_t keyframeInterval = 1024;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--keyframe" && i + 1 < argc) {
+            keyframeInterval = std::stoul(argv[++i]);
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 2) {
+        std::cerr << "Usage: lob_mbp <messages> <orderbook> [--out <file.mbp>] [--keyframe N]" << std::endl;
+        return 1;
+    }
+    const std::string& msgPath = positional[0];
+    const std::string& bookPath = positional[1];
+
+    LOB::OrderBook book;
+    LOB::MbpEncoder<kDepth> encoder(keyframeInterval);
+    std::vector<uint8_t> stream;
+    LOB::ReplayStats stats;
+    try {
+        EncodeHooks hooks;
+        hooks.encoder = &encoder;
+        hooks.out = &stream;
+        stats = LOB::replayVerified(book, msgPath, bookPath, hooks);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    if (!outPath.empty()) {
+        std::ofstream out(outPath, std::ios::binary);
+        out.write(reinterpret_cast<const char*>(stream.data()), static_cast<std::streamsize>(stream.size()));
+        if (!out) {
+            std::cerr << "Failed to write " << outPath << std::endl;
+            return 1;
+        }
+    }
+
+    // Decode the whole stream (best of 3)
+    uint64_t frames = 0;
+    LOB::DepthSnapshot<kDepth> decoded;
+    double decodeSeconds = bestOfSeconds(3, [&] {
+        LOB::MbpDecoder<kDepth> decoder(stream);
+        frames = 0;
+        while (decoder.next()) frames++;
+        decoded = decoder.book();
+    });
+
+    // Parse every CSV row (best of 3; the first run also warms the page cache)
+    uint64_t csvRows = 0;
+    uint64_t csvBytes = 0;
+    volatile uint64_t checksum = 0; // sink for the parsed rows, so the CSV parse can't be optimized away
+    double csvSeconds = 0.0;
+    try {
+        csvSeconds = bestOfSeconds(3, [&] {
+            auto source = LOB::openInput(bookPath);
+            csvRows = csvBytes = 0;
+            const char* begin;
+            const char* end;
+            while (source->nextChunk(begin, end)) {
+                csvBytes += static_cast<uint64_t>(end - begin);
+                const char* current = begin;
+                while (current < end) {
+                    auto levels = LOB::parseTruthLine(current, end);
+                    if (levels.empty()) break;
+                    checksum = checksum + static_cast<uint64_t>(levels[0].bidSize);
+                    csvRows++;
+                }
+            }
+        });
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    LOB::PriceLevel bids[kDepth], asks[kDepth];
+    const size_t bidCount = book.getDepth(LOB::Side::Buy, bids, kDepth);
+    const size_t askCount = book.getDepth(LOB::Side::Sell, asks, kDepth);
+    bool match = decoded.bidLevels == bidCount && decoded.askLevels == askCount;
+    for (size_t i = 0; match && i < bidCount; ++i) match = decoded.bids[i].price == bids[i].price && decoded.bids[i].volume == bids[i].volume;
+    for (size_t i = 0; match && i < askCount; ++i) match = decoded.asks[i].price == asks[i].price && decoded.asks[i].volume == asks[i].volume;
+
+    const double mbpBytes = static_cast<double>(stream.size());
+    std::cout << "Messages: " << stats.messages << " (" << stats.mismatches << " logic errors)" << std::endl;
+    std::cout << "MBP frames: " << encoder.frames() << " (" << encoder.keyframes() << " keyframes, "
+              << encoder.entries() << " level entries)" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Size:   CSV " << csvBytes / 1e6 << " MB (" << csvRows << " rows, "
+              << static_cast<double>(csvBytes) / std::max<uint64_t>(csvRows, 1) << " B/row)"
+              << " | MBP " << mbpBytes / 1e6 << " MB (" << mbpBytes / std::max<uint64_t>(encoder.frames(), 1) << " B/frame)"
+              << " | " << static_cast<double>(csvBytes) / std::max(mbpBytes, 1.0) << "x smaller" << std::endl;
+    std::cout << "Decode: CSV " << csvSeconds * 1e3 << " ms (" << csvSeconds * 1e9 / std::max<uint64_t>(csvRows, 1) << " ns/row)"
+              << " | MBP " << decodeSeconds * 1e3 << " ms (" << decodeSeconds * 1e9 / std::max<uint64_t>(frames, 1) << " ns/frame)"
+              << " | " << csvSeconds / std::max(decodeSeconds, 1e-12) << "x faster" << std::endl;
+    std::cout << std::defaultfloat << std::setprecision(6);
+    std::cout << "Decoded book matches replay: " << (match ? "yes" : "NO") << std::endl;
+
+    return match ? 0 : 2;
+}
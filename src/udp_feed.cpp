@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/UdpFeed.h"
+
+// Replays a day as a UDP feed on this host and measures the receiving side.
+//
+//   lob_udp <messages | day.bin> [--group ADDR] [--port P] [--speed X | --rate N]
+//           [--limit N] [--sweep] [--write-binary <out.bin>]
+//
+// Loads the day (LOBSTER CSV / .gz / .zst, or a binary feed file), starts a
+// UdpFeedHandler on its own thread and paces the messages out through a
+// UdpGateway on this one (see UdpFeed.h). Reports throughput, drops and the
+// handler's latency histograms. When nothing was dropped, it also checks that
+// the handler's book matches the same messages applied directly.
+//
+//   --group         127.0.0.1 (default, loopback unicast) or a multicast group such as
+//                   239.255.0.1 (looped back over lo)
+//   --port          UDP port (default: any free port)
+//   --speed         Event-time multiplier (default 1 = real time; 0 = as fast as possible)
+//   --rate          Evenly spaced at N messages/second instead of event time
+//   --limit         Replay only the first N messages
+//   --sweep         Double the rate, starting at --rate (default 100000), until packets drop
+//                   or the gateway cannot keep up; report the highest rate with no drops
+//   --write-binary  Save the loaded messages as a binary feed file and exit
+
+namespace {
+
+constexpr size_t kCompareDepth = 10;
+
+struct FeedRun {
+    LOB::GatewayStats gateway;
+    LOB::FeedStats feed;
+    LOB::LatencyHistogram packetLatency;
+    LOB::LatencyHistogram endToEnd;
+    bool bookMatches = false;
+};
+
+bool sameDepth(const LOB::OrderBook& a, const LOB::OrderBook& b) {
+    for (LOB::Side side : {LOB::Side::Buy, LOB::Side::Sell}) {
+        LOB::PriceLevel x[kCompareDepth], y[kCompareDepth];
+        const size_t n = a.getDepth(side, x, kCompareDepth);
+        if (n != b.getDepth(side, y, kCompareDepth)) return false;
+        for (size_t i = 0; i < n; ++i) {
+            if (x[i].price != y[i].price || x[i].volume != y[i].volume) return false;
+        }
+    }
+    return true;
+}
+
+FeedRun runFeed(std::span<const LOB::RAWMessage> messages, const LOB::UdpEndpoint& endpoint,
+                const LOB::FeedPacing& pacing, const LOB::OrderBook* reference) {
+    LOB::UdpFeedHandler handler(endpoint);
+    LOB::OrderBook book(messages.size());
+    std::exception_ptr handlerError;
+    std::thread receiver([&] {
+        try {
+            handler.run(book);
+        } catch (...) {
+            handlerError = std::current_exception();
+        }
+    });
+
+    LOB::UdpEndpoint target = endpoint;
+    target.port = handler.port();
+    FeedRun run;
+    uint64_t sentPackets = 0, sentMessages = 0;
+    try {
+        LOB::UdpGateway gateway(target);
+        run.gateway = gateway.replay(messages, pacing);
+        gateway.endOfStream();
+        sentPackets = gateway.nextSequence();
+        sentMessages = gateway.nextMessage();
+    } catch (...) {
+        handler.stop();
+        receiver.join();
+        throw;
+    }
+    receiver.join();
+    if (handlerError) std::rethrow_exception(handlerError);
+    // Timed out: the rest of the day never arrived
+    handler.countLostTail(sentPackets, sentMessages);
+
+    run.feed = handler.stats();
+    run.packetLatency = handler.packetLatency();
+    run.endToEnd = handler.endToEndLatency();
+    run.bookMatches = reference && run.feed.missedPackets == 0 && sameDepth(book, *reference);
+    return run;
+}
+
+double micros(uint64_t ns) { return static_cast<double>(ns) * 1e-3; }
+
+void printLatency(const char* name, const LOB::LatencyHistogram& h) {
+    std::cout << name << " (us): p50 " << micros(h.percentile(0.5)) << "  p90 " << micros(h.percentile(0.9))
+              << "  p99 " << micros(h.percentile(0.99)) << "  p99.9 " << micros(h.percentile(0.999))
+              << "  max " << micros(h.max()) << "  (" << h.count() << " samples)" << std::endl;
+}
+
+bool clean(const FeedRun& run, double targetRate) {
+    return run.feed.endOfStream && run.feed.missedPackets == 0 && run.feed.stale == 0 &&
+           run.gateway.messagesPerSecond() >= 0.95 * targetRate;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> positional;
+    LOB::UdpEndpoint endpoint;
+    LOB::FeedPacing pacing;
+    size_t limit = 0;
+    bool sweep = false;
+    std::string binaryOut;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--group" && i + 1 < argc) {
+            endpoint.address = argv[++i];
+        } else if (arg == "--port" && i + 1 < argc) {
+            endpoint.port = static_cast<uint16_t>(std::stoul(argv[++i]));
+        } else if (arg == "--speed" && i + 1 < argc) {
+            pacing.speed = std::stod(argv[++i]);
+        } else if (arg == "--rate" && i + 1 < argc) {
+            pacing.rate = std::stod(argv[++i]);
+        } else if (arg == "--limit" && i + 1 < argc) {
+            limit = std::stoul(argv[++i]);
+        } else if (arg == "--sweep") {
+            sweep = true;
+        } else if (arg == "--write-binary" && i + 1 < argc) {
+            binaryOut = argv[++i];
+        } else {
+            positional.push_back(arg);
+        }
+    }
+    if (positional.size() != 1) {
+        std::cerr << "Usage: lob_udp <messages | day.bin> [--group ADDR] [--port P] [--speed X | --rate N] "
+                     "[--limit N] [--sweep] [--write-binary <out.bin>]" << std::endl;
+        return 1;
+    }
+
+    std::vector<LOB::RAWMessage> messages;
+    try {
+        messages = LOB::loadFeedMessages(positional[0]);
+        if (limit > 0 && limit < messages.size()) messages.resize(limit);
+        if (!binaryOut.empty()) {
+            LOB::writeFeedFile(binaryOut, messages);
+            std::cout << "Wrote " << messages.size() << " messages to " << binaryOut << std::endl;
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    if (messages.empty()) {
+        std::cerr << "No messages in " << positional[0] << std::endl;
+        return 1;
+    }
+
+    LOB::OrderBook reference(messages.size());
+    reference.applyBatch(messages);
+
+    try {
+        if (sweep) {
+            double rate = pacing.rate > 0 ? pacing.rate : 100000.0;
+            double sustained = 0.0;
+            FeedRun best;
+            std::cout << "Rate sweep over " << messages.size() << " messages to " << endpoint.address << std::endl;
+            std::cout << std::fixed << std::setprecision(1);
+            for (;; rate *= 2) {
+                LOB::FeedPacing step;
+                step.rate = rate;
+                FeedRun run = runFeed(messages, endpoint, step, nullptr);
+                const bool ok = clean(run, rate);
+                std::cout << "  target " << std::setw(10) << rate << " msg/s | sent " << std::setw(10)
+                          << run.gateway.messagesPerSecond() << " | received " << std::setw(10) << run.feed.messagesPerSecond()
+                          << " | missed packets " << run.feed.missedPackets << " | packet p99 "
+                          << micros(run.packetLatency.percentile(0.99)) << " us | end-to-end p99 "
+                          << micros(run.endToEnd.percentile(0.99)) << " us" << (ok ? "" : "  <- limit") << std::endl;
+                if (!ok) break;
+                sustained = rate;
+                best = run;
+            }
+            if (sustained == 0.0) {
+                std::cout << "Dropped or fell behind even at the starting rate; try a lower --rate" << std::endl;
+                return 2;
+            }
+            std::cout << "Sustained without drops: " << sustained << " msg/s (" << sustained / 1e6 * sizeof(LOB::FeedRecord)
+                      << " MB/s of records)" << std::endl;
+            std::cout << std::defaultfloat << std::setprecision(6);
+            printLatency("Per-packet ", best.packetLatency);
+            printLatency("End-to-end ", best.endToEnd);
+            return 0;
+        }
+
+        FeedRun run = runFeed(messages, endpoint, pacing, &reference);
+        const LOB::FeedStats& feed = run.feed;
+        std::cout << "Gateway: " << run.gateway.messages << " messages in " << run.gateway.packets << " packets, "
+                  << run.gateway.sendCalls << " sendmmsg calls (" << run.gateway.sendRetries << " retries), "
+                  << run.gateway.heartbeats << " heartbeats, "
+                  << run.gateway.seconds << "s, max pacing lag " << micros(static_cast<uint64_t>(run.gateway.maxLagNs)) << " us"
+                  << std::endl;
+        std::cout << "Handler: " << feed.messages << " messages in " << feed.packets << " packets, " << feed.recvCalls
+                  << " recvmmsg calls, " << feed.heartbeats << " heartbeats, " << feed.messagesPerSecond() << " msg/s"
+                  << (feed.endOfStream ? "" : " (no end of stream: timed out)") << std::endl;
+        std::cout << "Gaps: " << feed.gaps << " (" << feed.missedPackets << " packets, " << feed.missedMessages
+                  << " messages lost), stale " << feed.stale << ", malformed " << feed.malformed << std::endl;
+        printLatency("Per-packet ", run.packetLatency);
+        printLatency("End-to-end ", run.endToEnd);
+        if (feed.missedPackets == 0) {
+            std::cout << "Book matches direct apply: " << (run.bookMatches ? "yes" : "NO") << std::endl;
+            return run.bookMatches ? 0 : 2;
+        }
+        return 2;
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
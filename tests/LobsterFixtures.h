@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/Replay.h"
+
+// Synthetic LOBSTER days shared by the replay tests.
+namespace LOB::test {
+
+// Random adds and full cancels around a fixed spread: bids at 10000 - k*100,
+// asks at 10100 + k*100 (k < 20), a message every millisecond from 09:30.
+inline std::vector<RAWMessage> randomFlow(int count, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<RAWMessage> live, messages;
+    messages.reserve(static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        RAWMessage msg{34200.0 + i * 1e-3, 1, 0, 0, 0, 1};
+        if (live.empty() || rng() % 3 != 0) {
+            msg.direction = (rng() & 1) ? 1 : -1;
+            msg.price = msg.direction == 1 ? 10000 - static_cast<int64_t>(rng() % 20) * 100 : 10100 + static_cast<int64_t>(rng() % 20) * 100;
+            msg.size = 1 + rng() % 100;
+            msg.orderId = static_cast<uint64_t>(i + 1);
+            live.push_back(msg);
+        } else {
+            size_t pick = rng() % live.size();
+            msg = live[pick];
+            msg.timestamp = 34200.0 + i * 1e-3;
+            msg.type = 3;
+            live[pick] = live.back();
+            live.pop_back();
+        }
+        messages.push_back(msg);
+    }
+    return messages;
+}
+
+// LOBSTER message file: Time,Type,OrderID,Size,Price,Direction
+inline void writeMessageFile(const std::filesystem::path& path, std::span<const RAWMessage> messages) {
+    std::ofstream out(path);
+    for (const RAWMessage& msg : messages) {
+        out << std::fixed << msg.timestamp << ',' << msg.type << ',' << msg.orderId << ',' << msg.size << ','
+            << msg.price << ',' << msg.direction << '\n';
+    }
+}
+
+// Matching orderbook file: after each message, the top 10 levels of a
+// reference book, padded with empty prices as LOBSTER does
+inline void writeOrderbookFile(const std::filesystem::path& path, std::span<const RAWMessage> messages) {
+    std::ofstream out(path);
+    OrderBook reference;
+    for (const RAWMessage& msg : messages) {
+        reference.apply(msg);
+        PriceLevel asks[10], bids[10];
+        size_t askCount = reference.getDepth(Side::Sell, asks, 10);
+        size_t bidCount = reference.getDepth(Side::Buy, bids, 10);
+        for (size_t lvl = 0; lvl < 10; ++lvl) {
+            if (lvl > 0) out << ',';
+            out << (lvl < askCount ? asks[lvl].price : kLobsterEmptyPrice) << ',' << (lvl < askCount ? asks[lvl].volume : 0) << ','
+                << (lvl < bidCount ? bids[lvl].price : kLobsterEmptyPrice) << ',' << (lvl < bidCount ? bids[lvl].volume : 0);
+        }
+        out << '\n';
+    }
+}
+
+// randomFlow written as a message file, plus its orderbook file if `orderbook` is set
+inline std::vector<RAWMessage> writeLobsterDay(const std::filesystem::path& messages, int count, uint64_t seed,
+                                               const std::filesystem::path& orderbook = {}) {
+    std::vector<RAWMessage> flow = randomFlow(count, seed);
+    writeMessageFile(messages, flow);
+    if (!orderbook.empty()) writeOrderbookFile(orderbook, flow);
+    return flow;
+}
+
+}
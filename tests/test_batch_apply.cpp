@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <unordered_map>
+#include <vector>
+#include "LOB/OrderBook.h"
+
+namespace {
+
+std::vector<LOB::PriceLevel> depthOf(const LOB::OrderBook& book, LOB::Side side) {
+    std::vector<LOB::PriceLevel> levels(4096);
+    levels.resize(book.getDepth(side, levels.data(), levels.size()));
+    return levels;
+}
+
+// Random but valid LOBSTER-like stream: adds, partial cancels, deletes, executions,
+// plus some messages for unknown IDs to exercise the fallback paths.
+std::vector<LOB::RAWMessage> randomStream(size_t count, uint32_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<LOB::RAWMessage> messages;
+    std::unordered_map<uint64_t, LOB::RAWMessage> live;
+    std::vector<uint64_t> ids;
+    uint64_t nextId = 1;
+
+    for (size_t i = 0; i < count; ++i) {
+        LOB::RAWMessage msg{static_cast<double>(i) * 1e-3, 1, 0, 0, 0, 1};
+        int roll = static_cast<int>(rng() % 10);
+        if (ids.empty() || roll < 4) {
+            msg.direction = (rng() & 1) ? 1 : -1;
+            msg.price = msg.direction == 1 ? 1000 - static_cast<int64_t>(rng() % 50) : 1001 + static_cast<int64_t>(rng() % 50);
+            msg.size = 1 + rng() % 100;
+            msg.orderId = nextId++;
+            live[msg.orderId] = msg;
+            ids.push_back(msg.orderId);
+        } else if (roll == 9) {
+            msg.type = 3;
+            msg.orderId = 1000000 + rng() % 1000; // unknown
+            msg.price = 1000;
+            msg.size = 5;
+        } else {
+            size_t pick = rng() % ids.size();
+            LOB::RAWMessage& order = live[ids[pick]];
+            msg.type = roll < 6 ? 2 : (roll < 8 ? 4 : 3);
+            msg.orderId = order.orderId;
+            msg.price = order.price;
+            msg.direction = order.direction;
+            msg.size = msg.type == 3 ? order.size : 1 + rng() % order.size;
+            order.size -= msg.size;
+            if (order.size == 0) {
+                live.erase(order.orderId);
+                ids[pick] = ids.back();
+                ids.pop_back();
+            }
+        }
+        messages.push_back(msg);
+    }
+    return messages;
+}
+
+}
+
+TEST(OrderIndexTest, MatchesUnorderedMap) {
+    LOB::OrderIndex index(16); // small start so the run rehashes several times
+    std::unordered_map<LOB::OrderID, LOB::Order*> reference;
+    std::vector<LOB::Order> storage(4096);
+    std::mt19937_64 rng(7);
+
+    for (int step = 0; step < 200000; ++step) {
+        // Narrow ID range forces long collision clusters and frequent erase-from-middle
+        LOB::OrderID id = rng() % 3000;
+        auto it = reference.find(id);
+        if (it == reference.end()) {
+            LOB::Order* order = &storage[id];
+            index.insert(id, order);
+            reference[id] = order;
+        } else {
+            index.erase(id);
+            reference.erase(it);
+        }
+        ASSERT_EQ(index.size(), reference.size());
+        if (step % 997 == 0) {
+            for (LOB::OrderID probe = 0; probe < 3000; ++probe) {
+                auto ref = reference.find(probe);
+                ASSERT_EQ(index.find(probe), ref == reference.end() ? nullptr : ref->second) << probe;
+            }
+        }
+    }
+
+    index.clear();
+    EXPECT_EQ(index.size(), 0u);
+    EXPECT_EQ(index.find(5), nullptr);
+}
+
+TEST(BatchApplyTest, MatchesSequentialApply) {
+    auto messages = randomStream(50000, 11);
+
+    LOB::OrderBook sequential;
+    for (const auto& msg : messages) sequential.apply(msg);
+
+    for (size_t batch : {1u, 3u, 64u, 50000u}) {
+        LOB::OrderBook batched;
+        std::span<const LOB::RAWMessage> all(messages);
+        for (size_t i = 0; i < all.size(); i += batch) {
+            batched.applyBatch(all.subspan(i, std::min(batch, all.size() - i)));
+        }
+
+        EXPECT_EQ(batched.getOrderCount(), sequential.getOrderCount()) << batch;
+        EXPECT_EQ(batched.getTopOfBook(), sequential.getTopOfBook()) << batch;
+        auto bids = depthOf(batched, LOB::Side::Buy);
+        auto refBids = depthOf(sequential, LOB::Side::Buy);
+        ASSERT_EQ(bids.size(), refBids.size()) << batch;
+        for (size_t i = 0; i < bids.size(); ++i) {
+            EXPECT_EQ(bids[i].price, refBids[i].price);
+            EXPECT_EQ(bids[i].volume, refBids[i].volume);
+        }
+        auto asks = depthOf(batched, LOB::Side::Sell);
+        auto refAsks = depthOf(sequential, LOB::Side::Sell);
+        ASSERT_EQ(asks.size(), refAsks.size()) << batch;
+        for (size_t i = 0; i < asks.size(); ++i) {
+            EXPECT_EQ(asks[i].price, refAsks[i].price);
+            EXPECT_EQ(asks[i].volume, refAsks[i].volume);
+        }
+    }
+}
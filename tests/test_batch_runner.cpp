@@ -0,0 +1,81 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/Replay.h"
+#include "LOB/WorkStealingPool.h"
+#include "LobsterFixtures.h"
+
+TEST(BatchRunnerTest, ResetBookMatchesFreshBook) {
+    LOB::OrderBook reused;
+    for (uint64_t i = 1; i <= 50000; ++i) {
+        reused.addOrder(i, 1000 + static_cast<int64_t>(i % 300), 10, i % 2 ? LOB::Side::Buy : LOB::Side::Sell, 0);
+    }
+    reused.addLevel(5000, 7, LOB::Side::Sell);
+    reused.reset();
+
+    EXPECT_EQ(reused.getOrderCount(), 0u);
+    EXPECT_EQ(reused.getTopOfBook(), LOB::TopOfBook{});
+    EXPECT_TRUE(reused.getLadder(LOB::Side::Buy).empty());
+    EXPECT_TRUE(reused.getLadder(LOB::Side::Sell).empty());
+
+    LOB::OrderBook fresh;
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        auto side = i % 3 ? LOB::Side::Buy : LOB::Side::Sell;
+        LOB::Price price = side == LOB::Side::Buy ? 900 - static_cast<int64_t>(i % 7) : 1100 + static_cast<int64_t>(i % 5);
+        reused.addOrder(i, price, i, side, 0);
+        fresh.addOrder(i, price, i, side, 0);
+    }
+    for (uint64_t i = 1; i <= 1000; i += 3) {
+        reused.cancelOrder(i);
+        fresh.cancelOrder(i);
+    }
+    EXPECT_EQ(reused.getOrderCount(), fresh.getOrderCount());
+    EXPECT_EQ(reused.getTopOfBook(), fresh.getTopOfBook());
+    EXPECT_EQ(reused.getCumulativeDepth(LOB::Side::Buy, 0), fresh.getCumulativeDepth(LOB::Side::Buy, 0));
+    EXPECT_EQ(reused.getCumulativeDepth(LOB::Side::Sell, 100000), fresh.getCumulativeDepth(LOB::Side::Sell, 100000));
+}
+
+TEST(BatchRunnerTest, WorkStealingRunsEveryJobOnce) {
+    constexpr size_t kJobs = 500;
+    constexpr size_t kWorkers = 4;
+    std::vector<size_t> order(kJobs);
+    for (size_t i = 0; i < kJobs; ++i) order[i] = kJobs - 1 - i;
+
+    std::vector<std::atomic<int>> runs(kJobs);
+    std::atomic<bool> badWorker{false};
+    auto stats = LOB::runWorkStealing(kWorkers, order, [&](size_t worker, size_t job) {
+        if (worker >= kWorkers) badWorker = true;
+        // Uneven job cost so queues drain at different rates and stealing kicks in
+        volatile uint64_t spin = 0;
+        for (size_t i = 0; i < (job % 7) * 2000; ++i) spin = spin + i;
+        runs[job]++;
+    });
+
+    EXPECT_FALSE(badWorker);
+    for (size_t j = 0; j < kJobs; ++j) EXPECT_EQ(runs[j].load(), 1) << j;
+    size_t executed = 0;
+    for (size_t w = 0; w < kWorkers; ++w) {
+        executed += stats.executed[w];
+        EXPECT_LE(stats.stolen[w], stats.executed[w]);
+    }
+    EXPECT_EQ(executed, kJobs);
+}
+
+TEST(BatchRunnerTest, ReplayVerifiedOnReusedBook) {
+    auto dir = std::filesystem::temp_directory_path() / "lob_batch_runner_test";
+    std::filesystem::create_directories(dir);
+    LOB::test::writeLobsterDay(dir / "message.csv", 5000, 3, dir / "orderbook.csv");
+
+    LOB::OrderBook book;
+    for (int run = 0; run < 2; ++run) {
+        if (run > 0) book.reset();
+        auto stats = LOB::replayVerified(book, (dir / "message.csv").string(), (dir / "orderbook.csv").string());
+        EXPECT_EQ(stats.messages, 5000u) << run;
+        EXPECT_EQ(stats.mismatches, 0u) << run;
+    }
+
+    std::filesystem::remove_all(dir);
+}
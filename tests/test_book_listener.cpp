@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "LOB/OrderBook.h"
+
+namespace {
+
+// Records every callback as a short string
+struct EventLog : LOB::BookListener {
+    std::vector<std::string>* events;
+
+    explicit EventLog(std::vector<std::string>* out) : events(out) {}
+
+    static const char* side(LOB::Side s) { return s == LOB::Side::Buy ? "bid" : "ask"; }
+
+    void onOrderAdded(const LOB::Order& o) { events->push_back("add " + std::to_string(o.id)); }
+    void onOrderReduced(const LOB::Order& o, LOB::Quantity by) {
+        events->push_back("reduce " + std::to_string(o.id) + " by " + std::to_string(by) + " to " + std::to_string(o.size));
+    }
+    void onOrderRemoved(const LOB::Order& o) { events->push_back("remove " + std::to_string(o.id)); }
+    void onLevelCreated(LOB::Side s, LOB::Price p) { events->push_back(std::string("level+ ") + side(s) + " " + std::to_string(p)); }
+    void onLevelRemoved(LOB::Side s, LOB::Price p) { events->push_back(std::string("level- ") + side(s) + " " + std::to_string(p)); }
+    void onBestPriceChanged(LOB::Side s, LOB::Price p) {
+        events->push_back(std::string("best ") + side(s) + " " + (p == LOB::INVALID_PRICE ? "none" : std::to_string(p)));
+    }
+};
+
+// Rebuilds levels and touch purely from callbacks
+struct Mirror : LOB::BookListener {
+    std::map<LOB::Price, LOB::Quantity> bids, asks;
+    std::map<LOB::OrderID, LOB::Quantity> orders;
+    LOB::Price bestBid = LOB::INVALID_PRICE;
+    LOB::Price bestAsk = LOB::INVALID_PRICE;
+
+    std::map<LOB::Price, LOB::Quantity>& levels(LOB::Side s) { return s == LOB::Side::Buy ? bids : asks; }
+
+    void onOrderAdded(const LOB::Order& o) {
+        orders[o.id] = o.size;
+        levels(o.side)[o.price] += o.size;
+    }
+    void onOrderReduced(const LOB::Order& o, LOB::Quantity by) {
+        orders[o.id] -= by;
+        levels(o.side)[o.price] -= by;
+    }
+    void onOrderRemoved(const LOB::Order& o) {
+        levels(o.side)[o.price] -= orders[o.id];
+        orders.erase(o.id);
+    }
+    void onLevelCreated(LOB::Side s, LOB::Price p) { levels(s).emplace(p, 0); }
+    void onLevelRemoved(LOB::Side s, LOB::Price p) { levels(s).erase(p); }
+    void onBestPriceChanged(LOB::Side s, LOB::Price p) { (s == LOB::Side::Buy ? bestBid : bestAsk) = p; }
+};
+
+}
+
+// Listeners that keep every default add no state to the book
+static_assert(sizeof(LOB::BasicOrderBook<LOB::BookListener>) == sizeof(LOB::OrderBook));
+
+TEST(BookListenerTest, CallbacksInOrder) {
+    std::vector<std::string> events;
+    LOB::BasicOrderBook<EventLog> book(1024, EventLog(&events));
+
+    book.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    book.addOrder(2, 100, 5, LOB::Side::Buy, 0);
+    book.addOrder(3, 99, 7, LOB::Side::Buy, 0);
+    book.addOrder(4, 105, 8, LOB::Side::Sell, 0);
+    book.executeOrder(1, 4, 100, LOB::Side::Buy);
+    book.cancelOrder(1);
+    book.apply(LOB::RAWMessage{0.0, 3, 2, 5, 100, 1});
+    book.cancelOrder(42); // unknown: nothing happens
+
+    std::vector<std::string> expected = {
+        "level+ bid 100", "add 1", "best bid 100",
+        "add 2",
+        "level+ bid 99", "add 3",
+        "level+ ask 105", "add 4", "best ask 105",
+        "reduce 1 by 4 to 6",
+        "remove 1",
+        "remove 2", "level- bid 100", "best bid 99",
+    };
+    EXPECT_EQ(events, expected);
+}
+
+TEST(BookListenerTest, MultipleListenersSeeTheSameStream) {
+    std::vector<std::string> first;
+    LOB::BasicOrderBook<EventLog, Mirror> book(1024, EventLog(&first), Mirror{});
+    book.addOrder(1, 100, 10, LOB::Side::Sell, 0);
+    book.addLevel(101, 50, LOB::Side::Sell); // snapshot volume: a level, but no order event
+    book.reduceOrder(1, 10, 100, LOB::Side::Sell);
+
+    std::vector<std::string> expected = {
+        "level+ ask 100", "add 1", "best ask 100",
+        "level+ ask 101",
+        "remove 1", "level- ask 100", "best ask 101",
+    };
+    EXPECT_EQ(first, expected);
+    EXPECT_EQ(book.listener<Mirror>().bestAsk, 101);
+    EXPECT_EQ(book.listener<Mirror>().asks.count(101), 1u);
+}
+
+// Fires once per call, and only when the price or size at the touch moved
+TEST(BookListenerTest, TopOfBookChangesOnlyAtTheTouch) {
+    struct Tops : LOB::BookListener {
+        std::vector<LOB::TopOfBook> seen;
+        void onTopOfBookChanged(const LOB::TopOfBook& top) { seen.push_back(top); }
+    };
+    LOB::BasicOrderBook<Tops> book(1024);
+    book.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    book.addOrder(2, 105, 8, LOB::Side::Sell, 0);
+    book.addOrder(3, 99, 7, LOB::Side::Buy, 0);    // behind the touch
+    book.addOrder(4, 100, 5, LOB::Side::Buy, 0);   // size at the touch
+    book.reduceOrder(3, 2, 99, LOB::Side::Buy);    // behind the touch
+    book.addLevel(105, 2, LOB::Side::Sell);        // snapshot volume at the touch
+    book.apply(LOB::RAWMessage{0.0, 3, 1, 10, 100, 1});
+    book.cancelOrder(42);                          // unknown
+
+    const std::vector<LOB::TopOfBook> expected = {
+        {100, 10, LOB::INVALID_PRICE, 0},
+        {100, 10, 105, 8},
+        {100, 15, 105, 8},
+        {100, 15, 105, 10},
+        {100, 5, 105, 10},
+    };
+    EXPECT_EQ(book.listener<Tops>().seen, expected);
+}
+
+TEST(BookListenerTest, MirrorTracksRandomFlow) {
+    LOB::BasicOrderBook<Mirror> book(4096);
+    std::mt19937_64 rng(5);
+    std::vector<LOB::RAWMessage> live;
+
+    for (int i = 0; i < 20000; ++i) {
+        LOB::RAWMessage msg{0.0, 1, 0, 0, 0, 1};
+        if (live.empty() || rng() % 3 == 0) {
+            msg.direction = (rng() & 1) ? 1 : -1;
+            msg.price = msg.direction == 1 ? 1000 - static_cast<int64_t>(rng() % 30) : 1001 + static_cast<int64_t>(rng() % 30);
+            msg.size = 1 + rng() % 50;
+            msg.orderId = static_cast<uint64_t>(i + 1);
+            live.push_back(msg);
+        } else {
+            size_t pick = rng() % live.size();
+            msg = live[pick];
+            msg.type = 2 + static_cast<int>(rng() % 3); // partial cancel, delete or execution
+            msg.size = msg.type == 3 ? live[pick].size : 1 + rng() % live[pick].size;
+            if (msg.type != 3 && msg.size < live[pick].size) {
+                live[pick].size -= msg.size;
+            } else {
+                live[pick] = live.back();
+                live.pop_back();
+            }
+        }
+        book.apply(msg);
+
+        const Mirror& mirror = book.listener<Mirror>();
+        const LOB::TopOfBook top = book.getTopOfBook();
+        ASSERT_EQ(mirror.bestBid, top.bidPrice) << "message " << i;
+        ASSERT_EQ(mirror.bestAsk, top.askPrice) << "message " << i;
+    }
+
+    const Mirror& mirror = book.listener<Mirror>();
+    EXPECT_EQ(mirror.orders.size(), book.getOrderCount());
+    for (LOB::Side side : {LOB::Side::Buy, LOB::Side::Sell}) {
+        const auto& levels = side == LOB::Side::Buy ? mirror.bids : mirror.asks;
+        const LOB::DepthLadder& ladder = book.getLadder(side);
+        ASSERT_EQ(levels.size(), ladder.size());
+        for (size_t i = 0; i < ladder.size(); ++i) {
+            EXPECT_EQ(levels.at(ladder.priceAt(i)), ladder.volumeAt(i));
+        }
+    }
+}
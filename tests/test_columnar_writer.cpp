@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "LOB/ColumnarWriter.h"
+#include "LOB/FeatureExporter.h"
+
+namespace {
+
+std::string readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+std::filesystem::path tempDir(const char* name) {
+    auto dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    return dir;
+}
+
+}
+
+// Rows spanning several chunks land contiguously after a fixed .npy header
+TEST(ColumnarWriterTest, WritesNpyColumns) {
+    auto dir = tempDir("lob_columnar_test");
+    {
+        LOB::ColumnarWriter writer(dir.string(), {{"id", LOB::ColumnType::UInt64}, {"px", LOB::ColumnType::Float64}}, 7, 2);
+        for (uint64_t i = 0; i < 100; ++i) {
+            writer.set<uint64_t>(0, i);
+            writer.set<double>(1, static_cast<double>(i) * 0.5);
+            writer.commitRow();
+        }
+        writer.close();
+        EXPECT_EQ(writer.rows(), 100u);
+    }
+
+    std::string ids = readFile(dir / "id.npy");
+    ASSERT_EQ(ids.size(), LOB::kNpyHeaderSize + 100 * sizeof(uint64_t));
+    EXPECT_EQ(ids.compare(0, 6, "\x93NUMPY"), 0);
+    EXPECT_NE(ids.find("'descr': '<u8'"), std::string::npos);
+    EXPECT_NE(ids.find("'shape': (100,)"), std::string::npos);
+    EXPECT_EQ(ids[LOB::kNpyHeaderSize - 1], '\n');
+
+    uint64_t id;
+    std::memcpy(&id, ids.data() + LOB::kNpyHeaderSize + 42 * sizeof(uint64_t), sizeof(id));
+    EXPECT_EQ(id, 42u);
+
+    std::string px = readFile(dir / "px.npy");
+    double last;
+    std::memcpy(&last, px.data() + px.size() - sizeof(double), sizeof(last));
+    EXPECT_DOUBLE_EQ(last, 49.5);
+
+    std::filesystem::remove_all(dir);
+}
+
+// The value type must be the column's type exactly, not just the same width
+// (float and other widths do not compile)
+TEST(ColumnarWriterTest, RejectsMismatchedValueTypes) {
+    static_assert(LOB::columnTypeOf<int32_t>() == LOB::ColumnType::Int32);
+    static_assert(LOB::columnTypeOf<uint32_t>() == LOB::ColumnType::UInt32);
+    static_assert(LOB::columnTypeOf<long long>() == LOB::ColumnType::Int64);
+    static_assert(LOB::columnTypeOf<uint64_t>() == LOB::ColumnType::UInt64);
+    static_assert(LOB::columnTypeOf<double>() == LOB::ColumnType::Float64);
+
+    auto dir = tempDir("lob_columnar_types_test");
+    {
+        LOB::ColumnarWriter writer(dir.string(), {{"n", LOB::ColumnType::Int32}, {"px", LOB::ColumnType::Int64}}, 4, 2);
+        EXPECT_THROW(writer.set<uint32_t>(0, 1u), std::invalid_argument);
+        EXPECT_THROW(writer.set<double>(1, 1.0), std::invalid_argument);
+        EXPECT_THROW(writer.set(1, 0), std::invalid_argument); // bare literal: int into int64
+        EXPECT_THROW(writer.set<int64_t>(2, 0), std::out_of_range);
+        writer.set<int32_t>(0, 7);
+        writer.set<int64_t>(1, 42);
+        writer.commitRow();
+        writer.close();
+        EXPECT_EQ(writer.rows(), 1u);
+    }
+    std::filesystem::remove_all(dir);
+}
+
+// Only the selected columns are produced; depth columns read the post-event book
+TEST(ColumnarWriterTest, FeatureExporterSelection) {
+    auto dir = tempDir("lob_exporter_test");
+    LOB::OrderBook book;
+    book.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    book.addOrder(2, 101, 20, LOB::Side::Sell, 0);
+
+    {
+        LOB::FeatureExporter exporter(dir.string(), {"timestamp", "bid_px_0", "ask_sz_1"}, 10);
+        exporter.record(LOB::RAWMessage{1.5, 1, 2, 20, 101, -1}, book);
+        exporter.close();
+    }
+
+    EXPECT_TRUE(std::filesystem::exists(dir / "bid_px_0.npy"));
+    EXPECT_FALSE(std::filesystem::exists(dir / "price.npy"));
+
+    std::string bid = readFile(dir / "bid_px_0.npy");
+    int64_t px;
+    std::memcpy(&px, bid.data() + LOB::kNpyHeaderSize, sizeof(px));
+    EXPECT_EQ(px, 100);
+
+    std::string ask = readFile(dir / "ask_sz_1.npy");
+    uint64_t sz;
+    std::memcpy(&sz, ask.data() + LOB::kNpyHeaderSize, sizeof(sz));
+    EXPECT_EQ(sz, 0u); // Only one ask level
+
+    EXPECT_THROW(LOB::FeatureExporter((dir / "bad").string(), {"no_such_column"}), std::invalid_argument);
+    std::filesystem::remove_all(dir);
+}
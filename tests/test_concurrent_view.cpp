@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "LOB/ConcurrentBookView.h"
+
+// Published view mirrors the book
+TEST(ConcurrentBookViewTest, PublishTopAndDepth) {
+    LOB::OrderBook book;
+    book.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    book.addOrder(2, 99, 20, LOB::Side::Buy, 0);
+    book.addOrder(3, 105, 30, LOB::Side::Sell, 0);
+
+    LOB::ConcurrentBookView<4> view;
+    view.publish(book);
+
+    EXPECT_EQ(view.getBestBid(), 100);
+    EXPECT_EQ(view.getBestAsk(), 105);
+    EXPECT_DOUBLE_EQ(view.getOBI(), book.getOBI());
+    EXPECT_DOUBLE_EQ(view.getMicroprice(), book.getMicroprice());
+
+    auto depth = view.getDepth();
+    ASSERT_EQ(depth.bidLevels, 2u);
+    ASSERT_EQ(depth.askLevels, 1u);
+    EXPECT_EQ(depth.bids[1].price, 99);
+    EXPECT_EQ(depth.bids[1].volume, 20u);
+    EXPECT_EQ(depth.asks[0].volume, 30u);
+}
+
+// Readers never observe a torn snapshot while the writer keeps publishing
+TEST(ConcurrentBookViewTest, SeqLockNoTornReads) {
+    struct Payload { uint64_t a, b, c, d, e; };
+    LOB::SeqLock<Payload> lock;
+    std::atomic<bool> done{false};
+    std::atomic<uint64_t> torn{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 2; ++r) {
+        readers.emplace_back([&] {
+            while (!done.load(std::memory_order_relaxed)) {
+                Payload p = lock.load();
+                if (p.a != p.b || p.b != p.c || p.c != p.d || p.d != p.e) torn++;
+            }
+        });
+    }
+
+    for (uint64_t i = 1; i <= 200000; ++i) {
+        lock.store({i, i, i, i, i});
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+
+    EXPECT_EQ(torn.load(), 0u);
+    EXPECT_EQ(lock.version(), 200000u);
+    EXPECT_EQ(lock.load().e, 200000u);
+}
+
+// Books with listeners publish the same way
+TEST(ConcurrentBookViewTest, PublishFromListenerBook) {
+    LOB::BasicOrderBook<LOB::BookListener> book(64);
+    book.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    book.addOrder(2, 105, 30, LOB::Side::Sell, 0);
+
+    LOB::ConcurrentBookView<4> view;
+    view.publish(book);
+    EXPECT_EQ(view.getBestBid(), 100);
+    EXPECT_EQ(view.getDepth().asks[0].volume, 30u);
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "LOB/ConsolidatedBook.h"
+
+namespace {
+
+// Reference: rescan every venue
+LOB::ConsolidatedQuote naiveQuote(const std::vector<LOB::TopOfBook>& venues) {
+    LOB::ConsolidatedQuote q;
+    for (size_t v = 0; v < venues.size(); ++v) {
+        const auto& top = venues[v];
+        if (top.bidPrice != LOB::INVALID_PRICE) {
+            if (q.bidPrice == LOB::INVALID_PRICE || top.bidPrice > q.bidPrice) {
+                q.bidPrice = top.bidPrice;
+                q.bidSize = 0;
+                q.bidVenues = 0;
+            }
+            if (top.bidPrice == q.bidPrice) {
+                q.bidSize += top.bidSize;
+                q.bidVenues |= uint64_t(1) << v;
+            }
+        }
+        if (top.askPrice != LOB::INVALID_PRICE) {
+            if (q.askPrice == LOB::INVALID_PRICE || top.askPrice < q.askPrice) {
+                q.askPrice = top.askPrice;
+                q.askSize = 0;
+                q.askVenues = 0;
+            }
+            if (top.askPrice == q.askPrice) {
+                q.askSize += top.askSize;
+                q.askVenues |= uint64_t(1) << v;
+            }
+        }
+    }
+    return q;
+}
+
+}
+
+TEST(ConsolidatedBookTest, TracksBooksAndMergesTies) {
+    LOB::OrderBook a, b, c;
+    LOB::ConsolidatedBook<4> nbbo(3);
+
+    a.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    a.addOrder(2, 105, 10, LOB::Side::Sell, 0);
+    nbbo.onBookChanged(0, a);
+    b.addOrder(1, 101, 5, LOB::Side::Buy, 0);
+    nbbo.onBookChanged(1, b);
+    c.addOrder(1, 101, 7, LOB::Side::Buy, 0);
+    c.addOrder(2, 104, 3, LOB::Side::Sell, 0);
+    nbbo.onBookChanged(2, c);
+
+    EXPECT_EQ(nbbo.quote().bidPrice, 101);
+    EXPECT_EQ(nbbo.quote().bidSize, 12u);
+    EXPECT_EQ(nbbo.quote().bidVenues, 0b110u);
+    EXPECT_EQ(nbbo.quote().askPrice, 104);
+    EXPECT_EQ(nbbo.quote().askSize, 3u);
+    EXPECT_EQ(nbbo.quote().askVenues, 0b100u);
+
+    // Best ask venue empties: falls back to venue 0
+    c.cancelOrder(2);
+    nbbo.onBookChanged(2, c);
+    EXPECT_EQ(nbbo.quote().askPrice, 105);
+    EXPECT_EQ(nbbo.quote().askVenues, 0b001u);
+
+    // Everything pulled
+    a.cancelOrder(1);
+    a.cancelOrder(2);
+    b.cancelOrder(1);
+    c.cancelOrder(1);
+    nbbo.onBookChanged(0, a);
+    nbbo.onBookChanged(1, b);
+    nbbo.onBookChanged(2, c);
+    EXPECT_EQ(nbbo.quote(), LOB::ConsolidatedQuote{});
+
+    // Only venues 0..2 exist, although the tree has room for 4
+    EXPECT_THROW(nbbo.onBookChanged(3, a), std::out_of_range);
+    EXPECT_THROW(nbbo.update(64, LOB::TopOfBook{}), std::out_of_range);
+    EXPECT_THROW(nbbo.venue(3), std::out_of_range);
+}
+
+TEST(ConsolidatedBookTest, MatchesRescanAndEmitsOnlyOnChange) {
+    constexpr size_t kVenues = 11; // not a power of two
+    std::mt19937_64 rng(5);
+    std::vector<LOB::TopOfBook> venues(kVenues);
+    LOB::ConsolidatedBook<16> nbbo(kVenues);
+
+    std::vector<LOB::ConsolidatedQuote> emitted;
+    nbbo.setListener([&](const LOB::ConsolidatedQuote& q) { emitted.push_back(q); });
+
+    LOB::ConsolidatedQuote last;
+    size_t expectedEvents = 0;
+    for (int step = 0; step < 100000; ++step) {
+        size_t v = rng() % kVenues;
+        LOB::TopOfBook top = venues[v];
+        switch (rng() % 4) {
+            case 0: top.bidPrice = 100 - static_cast<int64_t>(rng() % 5); top.bidSize = 1 + rng() % 3; break;
+            case 1: top.askPrice = 101 + static_cast<int64_t>(rng() % 5); top.askSize = 1 + rng() % 3; break;
+            case 2: top.bidPrice = LOB::INVALID_PRICE; top.bidSize = 0; break;
+            case 3: break; // unchanged quote
+        }
+        venues[v] = top;
+
+        bool changed = nbbo.update(v, top);
+        LOB::ConsolidatedQuote expected = naiveQuote(venues);
+        ASSERT_EQ(nbbo.quote(), expected) << step;
+        ASSERT_EQ(changed, !(expected == last)) << step;
+        if (changed) expectedEvents++;
+        last = expected;
+    }
+    EXPECT_EQ(emitted.size(), expectedEvents);
+    EXPECT_EQ(nbbo.changes(), expectedEvents);
+    EXPECT_LT(expectedEvents, 100000u);
+    EXPECT_EQ(emitted.back(), nbbo.quote());
+}
+
+// Venue books push their touch through a listener; no polling
+TEST(ConsolidatedBookTest, VenueListenersFeedTheQuote) {
+    using Nbbo = LOB::ConsolidatedBook<4>;
+    Nbbo nbbo(2);
+    std::vector<LOB::ConsolidatedQuote> emitted;
+    nbbo.setListener([&](const LOB::ConsolidatedQuote& q) { emitted.push_back(q); });
+    LOB::BasicOrderBook<Nbbo::VenueListener> a(64, {nbbo, 0});
+    LOB::BasicOrderBook<Nbbo::VenueListener> b(64, {nbbo, 1});
+    auto expectInSync = [&] {
+        EXPECT_EQ(nbbo.venue(0), a.getTopOfBook());
+        EXPECT_EQ(nbbo.venue(1), b.getTopOfBook());
+        EXPECT_EQ(nbbo.quote(), naiveQuote({a.getTopOfBook(), b.getTopOfBook()}));
+    };
+
+    a.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    a.addOrder(2, 105, 10, LOB::Side::Sell, 0);
+    b.addOrder(1, 100, 5, LOB::Side::Buy, 0);
+    expectInSync();
+    EXPECT_EQ(nbbo.quote().bidSize, 15u);
+    EXPECT_EQ(nbbo.quote().bidVenues, 0b11u);
+
+    // Behind the consolidated touch: no new quote
+    const size_t quotes = emitted.size();
+    a.addOrder(3, 99, 50, LOB::Side::Buy, 0);
+    b.addOrder(2, 106, 1, LOB::Side::Sell, 0);
+    expectInSync();
+    EXPECT_EQ(emitted.size(), quotes);
+
+    // Size at the touch, then a venue leaving it
+    b.addOrder(3, 100, 7, LOB::Side::Buy, 0);
+    EXPECT_EQ(nbbo.quote().bidSize, 22u);
+    a.cancelOrder(1);
+    expectInSync();
+    EXPECT_EQ(nbbo.quote().bidVenues, 0b10u);
+    EXPECT_EQ(emitted.size(), quotes + 2);
+    EXPECT_EQ(emitted.back(), nbbo.quote());
+
+    EXPECT_THROW(Nbbo::VenueListener(nbbo, 2), std::out_of_range);
+}
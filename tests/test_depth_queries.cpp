@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "LOB/OrderBook.h"
+
+namespace {
+
+// Reference: walk the side level by level through getDepth
+LOB::SweepEstimate naiveSweep(const LOB::OrderBook& book, LOB::Side side, LOB::Quantity size) {
+    std::vector<LOB::PriceLevel> levels(4096);
+    levels.resize(book.getDepth(side, levels.data(), levels.size()));
+    LOB::SweepEstimate est;
+    for (const auto& lvl : levels) {
+        if (est.filled == size) break;
+        LOB::Quantity take = std::min(lvl.volume, size - est.filled);
+        est.filled += take;
+        est.notional += lvl.price * static_cast<int64_t>(take);
+        est.lastPrice = lvl.price;
+        est.levels++;
+    }
+    return est;
+}
+
+}
+
+TEST(DepthQueryTest, SweepAcrossLevels) {
+    LOB::OrderBook book;
+    book.addOrder(1, 101, 10, LOB::Side::Sell, 0);
+    book.addOrder(2, 102, 20, LOB::Side::Sell, 0);
+    book.addOrder(3, 103, 30, LOB::Side::Sell, 0);
+
+    auto est = book.estimateSweep(LOB::Side::Sell, 25);
+    EXPECT_EQ(est.filled, 25u);
+    EXPECT_EQ(est.levels, 2u);
+    EXPECT_EQ(est.lastPrice, 102);
+    EXPECT_DOUBLE_EQ(est.vwap(), (101.0 * 10 + 102.0 * 15) / 25.0);
+
+    // More than available: fills what is there
+    est = book.estimateSweep(LOB::Side::Sell, 1000);
+    EXPECT_EQ(est.filled, 60u);
+    EXPECT_EQ(est.lastPrice, 103);
+
+    EXPECT_EQ(book.getPriceForSize(LOB::Side::Sell, 30), 102);
+    EXPECT_EQ(book.getPriceForSize(LOB::Side::Sell, 31), 103);
+    EXPECT_EQ(book.getPriceForSize(LOB::Side::Sell, 61), LOB::INVALID_PRICE);
+}
+
+TEST(DepthQueryTest, DepthNearMid) {
+    LOB::OrderBook book;
+    book.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    book.addOrder(2, 98, 20, LOB::Side::Buy, 0);
+    book.addOrder(3, 95, 40, LOB::Side::Buy, 0);
+    book.addOrder(4, 102, 5, LOB::Side::Sell, 0);
+
+    // mid = 101
+    EXPECT_EQ(book.getDepthNearMid(LOB::Side::Buy, 3), 30u);
+    EXPECT_EQ(book.getDepthNearMid(LOB::Side::Buy, 6), 70u);
+    EXPECT_EQ(book.getDepthNearMid(LOB::Side::Sell, 1), 5u);
+    EXPECT_EQ(book.getCumulativeDepth(LOB::Side::Buy, 99), 10u);
+
+    // Ladder tracks removals
+    book.cancelOrder(1);
+    EXPECT_EQ(book.getCumulativeDepth(LOB::Side::Buy, 99), 0u);
+    EXPECT_EQ(book.getLadder(LOB::Side::Buy).size(), 2u);
+}
+
+// Vectorized scans agree with a level-by-level walk on a randomized book
+TEST(DepthQueryTest, MatchesNaiveWalk) {
+    LOB::OrderBook book;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int64_t> priceDist(0, 300);
+    std::uniform_int_distribution<uint64_t> sizeDist(1, 500);
+
+    LOB::OrderID id = 1;
+    for (int i = 0; i < 3000; ++i) {
+        book.addOrder(id++, 1000 - priceDist(rng), sizeDist(rng), LOB::Side::Buy, 0);
+        book.addOrder(id++, 1001 + priceDist(rng), sizeDist(rng), LOB::Side::Sell, 0);
+        if (i % 3 == 0) book.reduceOrder(id - 3, sizeDist(rng), 0, LOB::Side::Buy);
+        if (i % 5 == 0) book.cancelOrder(id - 4);
+    }
+
+    for (LOB::Quantity size : {1ull, 77ull, 1000ull, 25000ull, 500000ull, 10000000ull}) {
+        for (LOB::Side side : {LOB::Side::Buy, LOB::Side::Sell}) {
+            auto fast = book.estimateSweep(side, size);
+            auto slow = naiveSweep(book, side, size);
+            EXPECT_EQ(fast.filled, slow.filled);
+            EXPECT_EQ(fast.notional, slow.notional);
+            EXPECT_EQ(fast.lastPrice, slow.lastPrice);
+            EXPECT_EQ(fast.levels, slow.levels);
+        }
+    }
+}
+
+// Every size against short ladders (exercises the vector/scalar boundary)
+TEST(DepthQueryTest, ShortLaddersEverySize) {
+    for (int levels = 1; levels <= 9; ++levels) {
+        LOB::OrderBook book;
+        for (int i = 0; i < levels; ++i) {
+            book.addOrder(static_cast<LOB::OrderID>(i + 1), 200 + i, static_cast<LOB::Quantity>(i + 1), LOB::Side::Sell, 0);
+        }
+        LOB::Quantity total = static_cast<LOB::Quantity>(levels * (levels + 1) / 2);
+        for (LOB::Quantity size = 0; size <= total + 1; ++size) {
+            auto fast = book.estimateSweep(LOB::Side::Sell, size);
+            auto slow = naiveSweep(book, LOB::Side::Sell, size);
+            EXPECT_EQ(fast.filled, slow.filled) << levels << "/" << size;
+            EXPECT_EQ(fast.notional, slow.notional) << levels << "/" << size;
+        }
+    }
+}
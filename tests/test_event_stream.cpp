@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "LOB/EventStream.h"
+#include "LobsterFixtures.h"
+
+namespace {
+
+std::filesystem::path tempPath(const std::string& name) {
+    return std::filesystem::temp_directory_path() / name;
+}
+
+}
+
+TEST(EventStreamTest, ChunksMatchDirectReplay) {
+    auto messages = tempPath("lob_event_stream_messages.csv");
+    auto written = LOB::test::writeLobsterDay(messages, 5500, 11);
+
+    LOB::EventStream stream(messages.string(), "", 1000, 2, 4096);
+    LOB::OrderBook book;
+    size_t index = 0;
+    std::vector<size_t> sizes;
+    while (auto chunk = stream.next()) {
+        sizes.push_back(chunk->records.size());
+        for (const LOB::EventRecord& event : chunk->records) {
+            ASSERT_LT(index, written.size());
+            const LOB::RAWMessage& msg = written[index++];
+            book.apply(msg);
+            const LOB::TopOfBook top = book.getTopOfBook();
+            EXPECT_EQ(event.type, msg.type);
+            EXPECT_EQ(event.direction, msg.direction);
+            EXPECT_EQ(event.orderId, msg.orderId);
+            EXPECT_EQ(event.size, msg.size);
+            EXPECT_EQ(event.price, msg.price);
+            EXPECT_NEAR(event.timestamp, msg.timestamp, 1e-6);
+            EXPECT_EQ(event.bidPrice, top.bidPrice);
+            EXPECT_EQ(event.bidSize, top.bidSize);
+            EXPECT_EQ(event.askPrice, top.askPrice);
+            EXPECT_EQ(event.askSize, top.askSize);
+        }
+    }
+    EXPECT_EQ(index, written.size());
+    EXPECT_EQ(sizes, (std::vector<size_t>{1000, 1000, 1000, 1000, 1000, 500}));
+    EXPECT_EQ(stream.stats().messages, 5500u);
+    EXPECT_EQ(stream.next(), nullptr);
+
+    std::filesystem::remove(messages);
+}
+
+TEST(EventStreamTest, VerifiedStreamSkipsSeedMessageAndHeals) {
+    auto messages = tempPath("lob_event_stream_verified_messages.csv");
+    auto orderbook = tempPath("lob_event_stream_verified_orderbook.csv");
+    auto written = LOB::test::writeLobsterDay(messages, 3000, 11, orderbook);
+
+    LOB::EventStream stream(messages.string(), orderbook.string(), 512, 1, 4096);
+    std::vector<LOB::EventRecord> events;
+    while (auto chunk = stream.next()) {
+        events.insert(events.end(), chunk->records.begin(), chunk->records.end());
+    }
+
+    // Message 1 is already in the first truth row, so it is not an event
+    ASSERT_EQ(events.size(), written.size() - 1);
+    EXPECT_EQ(events.front().orderId, written[1].orderId);
+    EXPECT_EQ(stream.stats().messages, written.size());
+    EXPECT_EQ(stream.stats().mismatches, 0u);
+
+    LOB::OrderBook reference;
+    for (size_t i = 0; i < written.size(); ++i) {
+        reference.apply(written[i]);
+        if (i == 0) continue;
+        const LOB::TopOfBook top = reference.getTopOfBook();
+        EXPECT_EQ(events[i - 1].bidPrice, top.bidPrice);
+        EXPECT_EQ(events[i - 1].askSize, top.askSize);
+    }
+
+    std::filesystem::remove(messages);
+    std::filesystem::remove(orderbook);
+}
+
+TEST(EventStreamTest, HeldChunksSurviveRecyclingAndEarlyShutdown) {
+    auto messages = tempPath("lob_event_stream_held_messages.csv");
+    auto written = LOB::test::writeLobsterDay(messages, 20000, 11);
+
+    std::shared_ptr<const LOB::EventChunk> first;
+    {
+        LOB::EventStream stream(messages.string(), "", 100, 1, 4096);
+        first = stream.next();
+        ASSERT_NE(first, nullptr);
+        // Drop a few chunks so they get recycled while `first` is still held
+        for (int i = 0; i < 10; ++i) ASSERT_NE(stream.next(), nullptr);
+        // The producer is blocked on the full queue, so there are no totals yet
+        EXPECT_THROW(stream.stats(), std::logic_error);
+        // Destroyed with most of the file unread: the producer must stop, not block
+    }
+    ASSERT_EQ(first->records.size(), 100u);
+    for (size_t i = 0; i < first->records.size(); ++i) {
+        EXPECT_EQ(first->records[i].orderId, written[i].orderId);
+    }
+
+    std::filesystem::remove(messages);
+}
+
+TEST(EventStreamTest, MissingFileThrowsFromNext) {
+    LOB::EventStream stream(tempPath("lob_event_stream_missing.csv").string());
+    EXPECT_THROW(stream.next(), std::exception);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <stdexcept>
+#include <vector>
+#include "LOB/FanOutReplay.h"
+#include "LobsterFixtures.h"
+
+TEST(FanOutReplayTest, EveryWorkerSeesEveryEventInOrder) {
+    auto path = std::filesystem::temp_directory_path() / "lob_fanout_messages.csv";
+    auto written = LOB::test::writeLobsterDay(path, 20000, 23);
+
+    // Expected post-event state
+    LOB::OrderBook reference(4096);
+    std::vector<LOB::TopOfBook> tops;
+    std::vector<LOB::Quantity> volumes;
+    for (const auto& msg : written) {
+        reference.apply(msg);
+        tops.push_back(reference.getTopOfBook());
+        volumes.push_back(reference.getVolumeAtPrice(msg.price, msg.direction == 1 ? LOB::Side::Buy : LOB::Side::Sell));
+    }
+
+    constexpr size_t kWorkers = 4;
+    std::vector<std::vector<LOB::TopOfBook>> seen(kWorkers);
+    std::vector<uint64_t> bad(kWorkers, 0);
+    LOB::FanOutConfig config;
+    config.ringCapacity = 64; // far smaller than the day: the producer has to wait for workers
+    config.maxBatch = 16;
+    config.expectedOrders = 4096;
+    auto stats = LOB::runFanOut(path.string(), "", kWorkers, [&](size_t w, std::span<const LOB::FanOutEvent> events) {
+        for (const auto& event : events) {
+            if (event.sequence != seen[w].size() || event.msg.orderId != written[event.sequence].orderId ||
+                event.levelVolume != volumes[event.sequence]) {
+                bad[w]++;
+            }
+            seen[w].push_back(event.top);
+        }
+    }, config);
+
+    EXPECT_EQ(stats.events, written.size());
+    EXPECT_EQ(stats.replay.messages, written.size());
+    for (size_t w = 0; w < kWorkers; ++w) {
+        EXPECT_EQ(bad[w], 0u);
+        EXPECT_EQ(stats.consumed[w], written.size());
+        EXPECT_EQ(seen[w], tops);
+    }
+
+    std::filesystem::remove(path);
+}
+
+namespace {
+
+// Listener on the producer's book; runFanOut default-constructs it
+struct AddCounter : LOB::BookListener {
+    static inline uint64_t added = 0;
+    void onOrderAdded(const LOB::Order&) { added++; }
+};
+
+}
+
+TEST(FanOutReplayTest, ProducerBookCanCarryListeners) {
+    auto path = std::filesystem::temp_directory_path() / "lob_fanout_listener_messages.csv";
+    auto written = LOB::test::writeLobsterDay(path, 5000, 29);
+    const auto adds = static_cast<uint64_t>(std::count_if(written.begin(), written.end(), [](const auto& m) { return m.type == 1; }));
+
+    AddCounter::added = 0;
+    uint64_t events = 0;
+    auto stats = LOB::runFanOut<LOB::BasicOrderBook<AddCounter>>(path.string(), "", 1,
+        [&](size_t, std::span<const LOB::FanOutEvent> span) { events += span.size(); });
+    EXPECT_EQ(stats.events, written.size());
+    EXPECT_EQ(events, written.size());
+    EXPECT_EQ(AddCounter::added, adds);
+
+    std::filesystem::remove(path);
+}
+
+TEST(FanOutReplayTest, LockstepBoundsSkewBetweenWorkers) {
+    auto path = std::filesystem::temp_directory_path() / "lob_fanout_lockstep_messages.csv";
+    auto written = LOB::test::writeLobsterDay(path, 20000, 23);
+
+    constexpr size_t kWorkers = 3;
+    LOB::FanOutConfig config;
+    config.mode = LOB::FanOutMode::Lockstep;
+    config.lockstepWindow = 100;
+    config.maxBatch = 32;
+    config.expectedOrders = 4096;
+
+    // Progress each worker has finished; the ring cursor trails it
+    std::atomic<uint64_t> done[kWorkers] = {};
+    std::atomic<uint64_t> worstSkew{0};
+    auto stats = LOB::runFanOut(path.string(), "", kWorkers, [&](size_t w, std::span<const LOB::FanOutEvent> events) {
+        const uint64_t end = events.back().sequence + 1;
+        uint64_t slowest = end;
+        for (size_t other = 0; other < kWorkers; ++other) {
+            if (other != w) slowest = std::min(slowest, done[other].load());
+        }
+        uint64_t skew = end - slowest;
+        uint64_t prev = worstSkew.load();
+        while (skew > prev && !worstSkew.compare_exchange_weak(prev, skew)) {}
+        // Worker 0 is slow, so the others would run ahead if they could
+        if (w == 0) std::this_thread::sleep_for(std::chrono::microseconds(20));
+        done[w].store(end);
+    }, config);
+
+    EXPECT_LE(worstSkew.load(), config.lockstepWindow);
+    for (size_t w = 0; w < kWorkers; ++w) EXPECT_EQ(stats.consumed[w], written.size());
+
+    std::filesystem::remove(path);
+}
+
+TEST(FanOutReplayTest, FailingWorkerIsDetachedAndRethrown) {
+    auto path = std::filesystem::temp_directory_path() / "lob_fanout_failing_messages.csv";
+    LOB::test::writeLobsterDay(path, 5000, 23);
+
+    LOB::FanOutConfig config;
+    config.ringCapacity = 128;
+    config.expectedOrders = 4096;
+    std::atomic<uint64_t> healthy{0};
+    EXPECT_THROW(LOB::runFanOut(path.string(), "", 2, [&](size_t w, std::span<const LOB::FanOutEvent> events) {
+        if (w == 1 && events.back().sequence > 1000) throw std::runtime_error("strategy failed");
+        if (w == 0) healthy += events.size();
+    }, config), std::runtime_error);
+    // The other worker still got the whole day
+    EXPECT_EQ(healthy.load(), 5000u);
+
+    EXPECT_THROW(LOB::runFanOut("/nonexistent/messages.csv", "", 2, [](size_t, std::span<const LOB::FanOutEvent>) {}),
+                 std::exception);
+
+    std::filesystem::remove(path);
+}
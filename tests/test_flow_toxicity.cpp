@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include "LOB/FlowToxicity.h"
+
+namespace {
+
+LOB::RAWMessage message(int type, uint64_t size, int64_t price, int direction) {
+    return LOB::RAWMessage{34200.0, type, 1, size, price, direction};
+}
+
+LOB::TopOfBook quote(int64_t bid, int64_t ask) {
+    return LOB::TopOfBook{bid, 100, ask, 100};
+}
+
+}
+
+TEST(FlowToxicityTest, SignsTrades) {
+    LOB::FlowToxicity tox;
+    tox.onEvent(message(1, 100, 10000, 1), quote(10000, 10100));
+
+    // Visible execution of a resting buy: seller-initiated
+    tox.onEvent(message(4, 30, 10000, 1), quote(10000, 10100));
+    EXPECT_EQ(tox.lastTradeSign(), -1);
+    // ...of a resting sell: buyer-initiated
+    tox.onEvent(message(4, 20, 10100, -1), quote(10000, 10100));
+    EXPECT_EQ(tox.lastTradeSign(), 1);
+    // Hidden: quote rule (below mid = sell), direction ignored
+    tox.onEvent(message(5, 10, 10020, -1), quote(10000, 10100));
+    EXPECT_EQ(tox.lastTradeSign(), -1);
+    // Hidden at the mid: tick rule (uptick from 10020 = buy)
+    tox.onEvent(message(5, 10, 10050, 1), quote(10000, 10100));
+    EXPECT_EQ(tox.lastTradeSign(), 1);
+
+    EXPECT_EQ(tox.tradeCount(), 4u);
+    EXPECT_EQ(tox.buyVolume(), 30u);
+    EXPECT_EQ(tox.sellVolume(), 40u);
+}
+
+TEST(FlowToxicityTest, VpinBucketsSplitTrades) {
+    LOB::ToxicityConfig config;
+    config.bucketVolume = 100;
+    config.vpinBuckets = 2;
+    LOB::FlowToxicity tox(config);
+    tox.onEvent(message(1, 100, 10000, 1), quote(10000, 10100));
+
+    tox.onEvent(message(4, 100, 10100, -1), quote(10000, 10100)); // bucket 1: +100
+    EXPECT_EQ(tox.bucketsCompleted(), 1u);
+    EXPECT_DOUBLE_EQ(tox.vpin(), 1.0);
+
+    tox.onEvent(message(4, 50, 10000, 1), quote(10000, 10100));   // bucket 2: -50 ...
+    tox.onEvent(message(4, 80, 10100, -1), quote(10000, 10100));  // ... +50 | bucket 3: +30
+    EXPECT_EQ(tox.bucketsCompleted(), 2u);
+    EXPECT_DOUBLE_EQ(tox.vpin(), 0.5);
+
+    tox.onEvent(message(4, 170, 10000, 1), quote(10000, 10100));  // bucket 3: +30 -70 | bucket 4: -100
+    EXPECT_EQ(tox.bucketsCompleted(), 4u);
+    // Window holds buckets 3 and 4 only
+    EXPECT_DOUBLE_EQ(tox.vpin(), (40.0 + 100.0) / 200.0);
+}
+
+TEST(FlowToxicityTest, KyleLambdaRecoversLinearImpact) {
+    LOB::ToxicityConfig config;
+    config.bucketVolume = 1; // one bucket per share: make every trade exactly one bucket
+    config.lambdaBuckets = 64;
+    LOB::FlowToxicity tox(config);
+    std::mt19937_64 rng(9);
+
+    // Each 1-share trade moves the mid by 25 price units in its direction
+    int64_t bid = 100000, ask = 100100;
+    tox.onEvent(message(1, 1, bid, 1), quote(bid, ask));
+    for (int i = 0; i < 1000; ++i) {
+        bool buy = rng() & 1;
+        int64_t move = buy ? 25 : -25;
+        bid += move;
+        ask += move;
+        tox.onEvent(message(4, 1, buy ? ask - move : bid - move, buy ? -1 : 1), quote(bid, ask));
+    }
+    EXPECT_NEAR(tox.kyleLambda(), 25.0, 1e-9);
+}
+
+TEST(FlowToxicityTest, CancelToTradeByLevel) {
+    LOB::ToxicityConfig config;
+    config.levels = 3;
+    config.eventWindow = 4;
+    LOB::FlowToxicity tox(config);
+    tox.onEvent(message(1, 100, 10000, 1), quote(10000, 10100));
+
+    tox.onEvent(message(3, 40, 10000, 1), quote(10000, 10100));  // bid touch: level 0
+    tox.onEvent(message(2, 10, 9900, 1), quote(10000, 10100));   // 1 tick: level 1
+    tox.onEvent(message(3, 5, 10900, -1), quote(10000, 10100));  // 8 ticks: deepest (2)
+    tox.onEvent(message(4, 20, 10100, -1), quote(10000, 10100)); // trade at the ask touch
+
+    EXPECT_EQ(tox.cancelVolume(0), 40u);
+    EXPECT_EQ(tox.cancelVolume(1), 10u);
+    EXPECT_EQ(tox.cancelVolume(2), 5u);
+    EXPECT_EQ(tox.tradeVolume(0), 20u);
+    EXPECT_DOUBLE_EQ(tox.cancelToTradeRatio(0), 2.0);
+
+    // Window of 4 events: the level-0 cancel drops out
+    tox.onEvent(message(4, 20, 10000, 1), quote(10000, 10100));
+    EXPECT_EQ(tox.cancelVolume(0), 0u);
+    EXPECT_EQ(tox.windowTradeVolume(), 40u);
+    EXPECT_DOUBLE_EQ(tox.cancelToTradeRatio(1), 0.25);
+}
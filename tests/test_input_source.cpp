@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "LOB/CSVParser.h"
+
+namespace {
+
+std::string makeMessages(int count) {
+    std::string text;
+    for (int i = 0; i < count; ++i) {
+        text += std::to_string(34200 + i) + ".000123456," + std::to_string(1 + i % 4) + "," + std::to_string(1000 + i) + ","
+              + std::to_string(10 + i % 90) + "," + std::to_string(5850000 + (i % 50) * 100) + "," + (i % 2 ? "1" : "-1") + "\n";
+    }
+    return text;
+}
+
+std::vector<LOB::RAWMessage> parseAll(LOB::LobsterMessageParser& parser) {
+    std::vector<LOB::RAWMessage> out;
+    LOB::RAWMessage msg;
+    while (parser.next(msg)) out.push_back(msg);
+    return out;
+}
+
+}
+
+TEST(InputSourceTest, PlainFileIsMapped) {
+    auto path = std::filesystem::temp_directory_path() / "lob_plain_messages.csv";
+    std::ofstream(path) << makeMessages(100);
+
+    LOB::LobsterMessageParser parser(path.string());
+    auto msgs = parseAll(parser);
+    ASSERT_EQ(msgs.size(), 100u);
+    EXPECT_EQ(msgs[99].orderId, 1099u);
+    EXPECT_FALSE(parser.hasNext());
+    std::filesystem::remove(path);
+}
+
+#ifdef LOB_HAVE_ZLIB
+// Lines straddling buffer boundaries are carried over; results match the mmap path
+TEST(InputSourceTest, GzipMatchesPlain) {
+    auto dir = std::filesystem::temp_directory_path();
+    auto plain = dir / "lob_gz_messages.csv";
+    auto gz = dir / "lob_gz_messages.csv.gz";
+    std::string text = makeMessages(20000);
+    std::ofstream(plain) << text;
+
+    gzFile out = gzopen(gz.string().c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    gzwrite(out, text.data(), static_cast<unsigned>(text.size()));
+    gzclose(out);
+
+    LOB::LobsterMessageParser plainParser(plain.string());
+    auto expected = parseAll(plainParser);
+
+    // Small buffers force many chunks
+    LOB::LobsterMessageParser gzParser(std::make_unique<LOB::DecompressingInputSource>(
+        std::make_unique<LOB::GzipDecoder>(gz.string()), 4096, 3));
+    auto actual = parseAll(gzParser);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i].orderId, expected[i].orderId) << i;
+        ASSERT_EQ(actual[i].price, expected[i].price) << i;
+        ASSERT_EQ(actual[i].direction, expected[i].direction) << i;
+        ASSERT_DOUBLE_EQ(actual[i].timestamp, expected[i].timestamp) << i;
+    }
+
+    // Extension-based dispatch picks the streaming source
+    LOB::LobsterMessageParser byName(gz.string());
+    EXPECT_EQ(parseAll(byName).size(), expected.size());
+
+    std::filesystem::remove(plain);
+    std::filesystem::remove(gz);
+}
+
+// A stream cut off mid-member is an error, not a short day
+TEST(InputSourceTest, TruncatedGzipThrows) {
+    auto gz = std::filesystem::temp_directory_path() / "lob_gz_truncated.csv.gz";
+    std::string text = makeMessages(20000);
+    gzFile out = gzopen(gz.string().c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    gzwrite(out, text.data(), static_cast<unsigned>(text.size()));
+    gzclose(out);
+    std::filesystem::resize_file(gz, std::filesystem::file_size(gz) / 2);
+
+    LOB::LobsterMessageParser parser(std::make_unique<LOB::DecompressingInputSource>(
+        std::make_unique<LOB::GzipDecoder>(gz.string()), 4096, 3));
+    EXPECT_THROW(parseAll(parser), std::runtime_error);
+    std::filesystem::remove(gz);
+}
+#endif
+
+#ifdef LOB_HAVE_ZSTD
+namespace {
+
+void writeZstd(const std::filesystem::path& path, const std::string& text) {
+    std::vector<char> compressed(ZSTD_compressBound(text.size()));
+    size_t size = ZSTD_compress(compressed.data(), compressed.size(), text.data(), text.size(), 3);
+    ASSERT_FALSE(ZSTD_isError(size));
+    std::ofstream(path, std::ios::binary).write(compressed.data(), static_cast<std::streamsize>(size));
+}
+
+}
+
+// The day spans several zstd blocks (128 KB) and hundreds of output buffers
+TEST(InputSourceTest, ZstdMatchesPlain) {
+    auto dir = std::filesystem::temp_directory_path();
+    auto plain = dir / "lob_zst_messages.csv";
+    auto zst = dir / "lob_zst_messages.csv.zst";
+    std::string text = makeMessages(20000);
+    std::ofstream(plain) << text;
+    writeZstd(zst, text);
+
+    LOB::LobsterMessageParser plainParser(plain.string());
+    auto expected = parseAll(plainParser);
+
+    LOB::LobsterMessageParser zstParser(std::make_unique<LOB::DecompressingInputSource>(
+        std::make_unique<LOB::ZstdDecoder>(zst.string()), 4096, 3));
+    auto actual = parseAll(zstParser);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        ASSERT_EQ(actual[i].orderId, expected[i].orderId) << i;
+        ASSERT_EQ(actual[i].price, expected[i].price) << i;
+        ASSERT_DOUBLE_EQ(actual[i].timestamp, expected[i].timestamp) << i;
+    }
+
+    LOB::LobsterMessageParser byName(zst.string());
+    EXPECT_EQ(parseAll(byName).size(), expected.size());
+
+    std::filesystem::remove(plain);
+    std::filesystem::remove(zst);
+}
+
+TEST(InputSourceTest, TruncatedZstdThrows) {
+    auto zst = std::filesystem::temp_directory_path() / "lob_zst_truncated.csv.zst";
+    writeZstd(zst, makeMessages(20000));
+    std::filesystem::resize_file(zst, std::filesystem::file_size(zst) - 16);
+
+    // With the default 4 MB buffers the whole file decodes before the first chunk
+    EXPECT_THROW({
+        LOB::LobsterMessageParser parser(zst.string());
+        parseAll(parser);
+    }, std::runtime_error);
+    std::filesystem::remove(zst);
+}
+#endif
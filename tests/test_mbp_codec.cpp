@@ -0,0 +1,159 @@
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <vector>
+#include "LOB/MbpCodec.h"
+
+namespace {
+
+constexpr size_t kDepth = 5;
+
+struct EncodedFrame {
+    size_t offset;  // first byte of the frame
+    bool keyframe;
+    int64_t timeNs;
+    LOB::DepthSnapshot<kDepth> book;
+};
+
+LOB::DepthSnapshot<kDepth> topOf(const LOB::OrderBook& book) {
+    LOB::DepthSnapshot<kDepth> snap;
+    snap.bidLevels = static_cast<uint32_t>(book.getDepth(LOB::Side::Buy, snap.bids, kDepth));
+    snap.askLevels = static_cast<uint32_t>(book.getDepth(LOB::Side::Sell, snap.asks, kDepth));
+    return snap;
+}
+
+void expectSameBook(const LOB::DepthSnapshot<kDepth>& a, const LOB::DepthSnapshot<kDepth>& b) {
+    ASSERT_EQ(a.bidLevels, b.bidLevels);
+    ASSERT_EQ(a.askLevels, b.askLevels);
+    for (size_t i = 0; i < a.bidLevels; ++i) {
+        EXPECT_EQ(a.bids[i].price, b.bids[i].price);
+        EXPECT_EQ(a.bids[i].volume, b.bids[i].volume);
+    }
+    for (size_t i = 0; i < a.askLevels; ++i) {
+        EXPECT_EQ(a.asks[i].price, b.asks[i].price);
+        EXPECT_EQ(a.asks[i].volume, b.asks[i].volume);
+    }
+}
+
+// Random adds/cancels/executions around a moving mid, encoded after every message
+std::vector<EncodedFrame> encodeRandomFlow(std::vector<uint8_t>& out, size_t keyframeInterval, int messages) {
+    LOB::OrderBook book(4096);
+    LOB::MbpEncoder<kDepth> encoder(keyframeInterval);
+    std::mt19937_64 rng(17);
+    std::vector<LOB::RAWMessage> live;
+    std::vector<EncodedFrame> frames;
+    int64_t mid = 500000;
+
+    for (int i = 0; i < messages; ++i) {
+        LOB::RAWMessage msg{34200.0 + i * 1e-4, 1, 0, 0, 0, 1};
+        if (live.empty() || rng() % 2 == 0) {
+            mid += static_cast<int64_t>(rng() % 3) * 100 - 100;
+            msg.direction = (rng() & 1) ? 1 : -1;
+            msg.price = msg.direction == 1 ? mid - 100 * static_cast<int64_t>(rng() % 8) : mid + 100 + 100 * static_cast<int64_t>(rng() % 8);
+            msg.size = 1 + rng() % 500;
+            msg.orderId = static_cast<uint64_t>(i + 1);
+            live.push_back(msg);
+        } else {
+            size_t pick = rng() % live.size();
+            msg = live[pick];
+            msg.timestamp = 34200.0 + i * 1e-4;
+            msg.type = (rng() & 1) ? 3 : 4;
+            live[pick] = live.back();
+            live.pop_back();
+        }
+        book.apply(msg);
+
+        const size_t offset = out.size();
+        const uint64_t keyframesBefore = encoder.keyframes();
+        if (encoder.encode(book, msg.timestamp, out)) {
+            frames.push_back(EncodedFrame{offset, encoder.keyframes() != keyframesBefore, LOB::toNanoseconds(msg.timestamp), topOf(book)});
+        }
+    }
+    return frames;
+}
+
+}
+
+TEST(MbpCodecTest, VarintAndZigzagRoundTrip) {
+    const int64_t values[] = {0, 1, -1, 63, -64, 64, 300, -300, std::numeric_limits<int64_t>::max(), std::numeric_limits<int64_t>::min()};
+    std::vector<uint8_t> bytes;
+    for (int64_t v : values) LOB::putVarint(bytes, LOB::zigzagEncode(v));
+    EXPECT_EQ(LOB::zigzagEncode(-1), 1u);
+    EXPECT_EQ(LOB::zigzagEncode(1), 2u);
+
+    const uint8_t* p = bytes.data();
+    for (int64_t v : values) EXPECT_EQ(LOB::zigzagDecode(LOB::getVarint(p, bytes.data() + bytes.size())), v);
+    EXPECT_EQ(p, bytes.data() + bytes.size());
+    // Small offsets are one byte
+    std::vector<uint8_t> one;
+    LOB::putVarint(one, LOB::zigzagEncode(-63));
+    EXPECT_EQ(one.size(), 1u);
+}
+
+TEST(MbpCodecTest, DecoderRebuildsEveryFrame) {
+    std::vector<uint8_t> bytes;
+    auto frames = encodeRandomFlow(bytes, 64, 20000);
+    ASSERT_GT(frames.size(), 1000u);
+
+    // Keyframe period is exactly the interval
+    for (size_t f = 0; f < frames.size(); ++f) ASSERT_EQ(frames[f].keyframe, f % 64 == 0) << f;
+
+    LOB::MbpDecoder<kDepth> decoder(bytes);
+    for (const EncodedFrame& frame : frames) {
+        ASSERT_TRUE(decoder.next());
+        EXPECT_EQ(decoder.keyframe(), frame.keyframe);
+        EXPECT_EQ(decoder.timestampNs(), frame.timeNs);
+        expectSameBook(decoder.book(), frame.book);
+    }
+    EXPECT_FALSE(decoder.next());
+    EXPECT_EQ(decoder.remaining(), 0u);
+}
+
+TEST(MbpCodecTest, LateJoinerSyncsAtNextKeyframe) {
+    std::vector<uint8_t> bytes;
+    auto frames = encodeRandomFlow(bytes, 100, 5000);
+
+    // Start at a delta frame in the middle of the stream
+    size_t start = frames.size() / 2;
+    while (frames[start].keyframe) start++;
+    size_t firstKey = start;
+    while (!frames[firstKey].keyframe) firstKey++;
+
+    LOB::MbpDecoder<kDepth> decoder(bytes.data() + frames[start].offset, bytes.size() - frames[start].offset);
+    ASSERT_TRUE(decoder.next());
+    EXPECT_TRUE(decoder.keyframe());
+    EXPECT_EQ(decoder.timestampNs(), frames[firstKey].timeNs);
+    expectSameBook(decoder.book(), frames[firstKey].book);
+    for (size_t f = firstKey + 1; f < frames.size(); ++f) {
+        ASSERT_TRUE(decoder.next());
+        expectSameBook(decoder.book(), frames[f].book);
+    }
+}
+
+TEST(MbpCodecTest, DeltaFramesAreCompact) {
+    std::vector<uint8_t> bytes;
+    auto frames = encodeRandomFlow(bytes, 1000000, 20000);
+    // One keyframe, then deltas of a few entries near the touch
+    EXPECT_LT(static_cast<double>(bytes.size()) / static_cast<double>(frames.size()), 10.0);
+}
+
+TEST(MbpCodecTest, MalformedInputThrows) {
+    std::vector<uint8_t> bytes;
+    encodeRandomFlow(bytes, 64, 200);
+
+    std::vector<uint8_t> truncated(bytes.begin(), bytes.end() - 1);
+    LOB::MbpDecoder<kDepth> decoder(truncated);
+    EXPECT_THROW(while (decoder.next()) {}, std::runtime_error);
+
+    // A keyframe, then an update of a level that does not exist
+    std::vector<uint8_t> bad;
+    LOB::putVarint(bad, 1);      // keyframe, no entries
+    LOB::putVarint(bad, 0);
+    LOB::putVarint(bad, 1 << 1); // delta frame, one entry
+    LOB::putVarint(bad, 0);
+    LOB::putVarint(bad, LOB::zigzagEncode(100) << 3 | static_cast<uint64_t>(LOB::MbpOp::Update));
+    LOB::putVarint(bad, 5);
+    LOB::MbpDecoder<kDepth> badDecoder(bad);
+    EXPECT_TRUE(badDecoder.next());
+    EXPECT_THROW(badDecoder.next(), std::runtime_error);
+}
@@ -47,6 +47,19 @@ TEST(OrderBookTest, ExecuteOrder) {
     EXPECT_EQ(book.getOrderCount(), 0);
 }
 
+// A locked price rests on both sides; the side-aware query tells them apart
+TEST(OrderBookTest, VolumeAtPriceBySide) {
+    LOB::OrderBook book;
+    book.addOrder(1, 100, 10, LOB::Side::Buy, 0);
+    book.addOrder(2, 100, 25, LOB::Side::Sell, 0);
+    book.addOrder(3, 101, 7, LOB::Side::Sell, 0);
+
+    EXPECT_EQ(book.getVolumeAtPrice(100, LOB::Side::Buy), 10);
+    EXPECT_EQ(book.getVolumeAtPrice(100, LOB::Side::Sell), 25);
+    EXPECT_EQ(book.getVolumeAtPrice(101, LOB::Side::Buy), 0);
+    EXPECT_EQ(book.getVolumeAtPrice(101, LOB::Side::Sell), 7);
+}
+
 // Test OBI Calculation
 TEST(OrderBookTest, OBI) {
     LOB::OrderBook book;
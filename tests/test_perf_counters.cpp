@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "LOB/PerfCounters.h"
+
+// Works whether or not the host exposes a PMU: unavailable events read as zero
+TEST(PerfCountersTest, DegradesCleanly) {
+    LOB::PerfCounters counters;
+    counters.start();
+    LOB::PerfSample before = counters.read();
+
+    volatile uint64_t sink = 0;
+    for (uint64_t i = 0; i < 100000; ++i) sink = sink + i;
+
+    LOB::PerfSample delta = counters.read() - before;
+    counters.stop();
+
+    if (!counters.available()) {
+        EXPECT_FALSE(counters.error().empty());
+        for (size_t i = 0; i < LOB::kPerfEventCount; ++i) EXPECT_EQ(delta.values[i], 0u);
+        EXPECT_FALSE(delta.multiplexed());
+        return;
+    }
+    if (counters.available(LOB::PerfEvent::Instructions)) {
+        EXPECT_GT(delta.scaled(LOB::PerfEvent::Instructions), 100000.0);
+    }
+}
+
+// A group that ran for part of the interval is scaled up to the whole of it
+TEST(PerfCountersTest, ScalesMultiplexedSamples) {
+    LOB::PerfSample before, after;
+    before.values[0] = 1000;
+    before.timeEnabled = 500;
+    before.timeRunning = 500;
+    after.values[0] = 3000;
+    after.timeEnabled = 1500;
+    after.timeRunning = 1000;
+
+    LOB::PerfSample delta = after - before;
+    EXPECT_TRUE(delta.multiplexed());
+    EXPECT_EQ(delta[LOB::PerfEvent::Cycles], 2000u);
+    EXPECT_DOUBLE_EQ(delta.scaled(LOB::PerfEvent::Cycles), 4000.0);
+
+    // Never scheduled: nothing to extrapolate from
+    LOB::PerfSample idle;
+    idle.timeEnabled = 100;
+    EXPECT_TRUE(idle.multiplexed());
+    EXPECT_EQ(idle.scaled(LOB::PerfEvent::Cycles), 0.0);
+
+    LOB::PerfSample full = before;
+    EXPECT_FALSE(full.multiplexed());
+    EXPECT_DOUBLE_EQ(full.scaled(LOB::PerfEvent::Cycles), 1000.0);
+}
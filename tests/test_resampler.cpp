@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+#include "LOB/Resampler.h"
+
+namespace {
+
+LOB::RAWMessage makeMsg(double ts, int type, uint64_t size, int64_t price) {
+    return LOB::RAWMessage{ts, type, 1, size, price, 1};
+}
+
+LOB::TopOfBook makeTop(LOB::Price bid, LOB::Price ask) {
+    return LOB::TopOfBook{bid, 100, ask, 200};
+}
+
+// Sink that keeps every bar per width
+struct BarLog {
+    std::vector<std::vector<LOB::Bar>> bars;
+    explicit BarLog(size_t widths) : bars(widths) {}
+    LOB::Resampler::BarSink sink() {
+        return [this](size_t w, const LOB::Bar& bar) { bars[w].push_back(bar); };
+    }
+};
+
+}
+
+// OHLC / VWAP / counts within a bucket, snapshot taken after the last event
+TEST(ResamplerTest, AggregatesTradesPerBucket) {
+    BarLog log(1);
+    LOB::Resampler resampler({1.0}, log.sink());
+
+    resampler.onEvent(makeMsg(10.1, 1, 50, 1000), makeTop(999, 1001));
+    resampler.onEvent(makeMsg(10.2, 4, 10, 1001), makeTop(999, 1003));
+    resampler.onEvent(makeMsg(10.5, 5, 30, 1003), makeTop(998, 1003));
+    resampler.onEvent(makeMsg(10.9, 4, 10, 1002), makeTop(1000, 1002));
+    resampler.onEvent(makeMsg(11.0, 1, 5, 900), makeTop(1000, 1002)); // Next bucket
+    resampler.flush();
+
+    const auto& bars = log.bars[0];
+    ASSERT_EQ(bars.size(), 2u);
+    EXPECT_DOUBLE_EQ(bars[0].startTime, 10.0);
+    EXPECT_EQ(bars[0].open, 1001);
+    EXPECT_EQ(bars[0].high, 1003);
+    EXPECT_EQ(bars[0].low, 1001);
+    EXPECT_EQ(bars[0].close, 1002);
+    EXPECT_EQ(bars[0].volume, 50u);
+    EXPECT_EQ(bars[0].tradeCount, 3u);
+    EXPECT_EQ(bars[0].eventCount, 4u);
+    EXPECT_DOUBLE_EQ(bars[0].vwap, (1001.0 * 10 + 1003.0 * 30 + 1002.0 * 10) / 50.0);
+    EXPECT_DOUBLE_EQ(bars[0].meanSpread, (2.0 + 4.0 + 5.0 + 2.0) / 4.0);
+    EXPECT_EQ(bars[0].bidPrice, 1000);
+    EXPECT_EQ(bars[0].askPrice, 1002);
+
+    // Second bucket has no trades
+    EXPECT_EQ(bars[1].tradeCount, 0u);
+    EXPECT_EQ(bars[1].open, LOB::INVALID_PRICE);
+}
+
+// Gaps emit empty buckets carrying the last book state; widths are independent
+TEST(ResamplerTest, MultipleWidthsAndGaps) {
+    BarLog log(2);
+    LOB::Resampler resampler({0.1, 1.0}, log.sink());
+
+    resampler.onEvent(makeMsg(5.05, 1, 1, 100), makeTop(99, 101));
+    resampler.onEvent(makeMsg(5.42, 1, 1, 100), makeTop(98, 101));
+    resampler.flush();
+
+    const auto& fine = log.bars[0];
+    ASSERT_EQ(fine.size(), 5u); // 5.0, 5.1, 5.2, 5.3, 5.4
+    EXPECT_EQ(fine[1].eventCount, 0u);
+    EXPECT_EQ(fine[3].bidPrice, 99);
+    EXPECT_DOUBLE_EQ(fine[2].meanSpread, 2.0);
+    EXPECT_EQ(fine[4].bidPrice, 98);
+    EXPECT_NEAR(fine[4].startTime, 5.4, 1e-9);
+
+    const auto& coarse = log.bars[1];
+    ASSERT_EQ(coarse.size(), 1u);
+    EXPECT_EQ(coarse[0].eventCount, 2u);
+}
+
+// Bars are handed out as they close, before the day ends
+TEST(ResamplerTest, StreamsBarsAsTheyClose) {
+    BarLog log(1);
+    LOB::Resampler resampler({1.0}, log.sink());
+    resampler.onEvent(makeMsg(1.5, 1, 1, 100), makeTop(99, 101));
+    EXPECT_TRUE(log.bars[0].empty());
+    resampler.onEvent(makeMsg(3.2, 1, 1, 100), makeTop(99, 101));
+    ASSERT_EQ(log.bars[0].size(), 2u); // 1.0 and the empty 2.0
+    EXPECT_EQ(log.bars[0][1].eventCount, 0u);
+
+    auto dir = std::filesystem::temp_directory_path() / "lob_bar_writer_test";
+    std::filesystem::remove_all(dir);
+    {
+        LOB::BarWriter writer(dir.string(), 2);
+        for (const LOB::Bar& bar : log.bars[0]) writer.write(bar);
+        writer.close();
+        EXPECT_EQ(writer.rows(), 2u);
+    }
+    // 128-byte .npy header + 2 rows
+    EXPECT_EQ(std::filesystem::file_size(dir / "start_time.npy"), 128u + 2 * sizeof(double));
+    EXPECT_EQ(std::filesystem::file_size(dir / "trade_count.npy"), 128u + 2 * sizeof(uint32_t));
+    std::ifstream in(dir / "bid_px.npy", std::ios::binary);
+    in.seekg(128);
+    int64_t bid = 0;
+    in.read(reinterpret_cast<char*>(&bid), sizeof(bid));
+    EXPECT_EQ(bid, 99);
+    std::filesystem::remove_all(dir);
+}
+
+// A mistyped width must not turn a quiet spell into billions of bars
+TEST(ResamplerTest, RejectsSubMicrosecondWidths) {
+    BarLog log(1);
+    EXPECT_THROW(LOB::Resampler({0.0}, log.sink()), std::invalid_argument);
+    EXPECT_THROW(LOB::Resampler({1.0, -1.0}, log.sink()), std::invalid_argument);
+    EXPECT_THROW(LOB::Resampler({1e-7}, log.sink()), std::invalid_argument);
+    EXPECT_NO_THROW(LOB::Resampler({1e-6}, log.sink()));
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/SlabAllocator.h"
+
+namespace {
+
+using Slab = LOB::SlabAllocator<LOB::Order>;
+constexpr size_t kPerBlock = Slab::kObjectsPerBlock;
+
+}
+
+TEST(SlabAllocatorTest, GrowsAndReturnsBlocksToPool) {
+    Slab::Pool pool;
+    Slab slab(kPerBlock, pool); // hint: one block
+    EXPECT_EQ(slab.blockCount(), 1u);
+    EXPECT_EQ(pool.outstandingBlocks(), 1u);
+
+    std::vector<LOB::Order*> orders;
+    for (size_t i = 0; i < 10 * kPerBlock; ++i) orders.push_back(slab.allocate());
+    EXPECT_EQ(slab.blockCount(), 10u);
+    EXPECT_EQ(slab.liveObjects(), 10 * kPerBlock);
+    std::set<LOB::Order*> distinct(orders.begin(), orders.end());
+    EXPECT_EQ(distinct.size(), orders.size());
+
+    // Free everything: back to the hint (whose empty block is also the spare)
+    for (LOB::Order* order : orders) slab.deallocate(order);
+    EXPECT_EQ(slab.liveObjects(), 0u);
+    EXPECT_EQ(slab.blockCount(), 1u);
+    EXPECT_EQ(pool.outstandingBlocks(), 1u);
+    EXPECT_EQ(pool.cachedBlocks(), 9u);
+
+    // Regrowth reuses the cached blocks
+    orders.clear();
+    for (size_t i = 0; i < 5 * kPerBlock; ++i) orders.push_back(slab.allocate());
+    EXPECT_EQ(pool.cachedBlocks(), 5u);
+    for (LOB::Order* order : orders) slab.deallocate(order);
+
+    slab.reset();
+    EXPECT_EQ(slab.blockCount(), 1u);
+    pool.trim();
+    EXPECT_EQ(pool.cachedBlocks(), 0u);
+}
+
+// Spare blocks beyond twice the live ones (and the pool's keep) go back to the system
+TEST(SlabAllocatorTest, PoolFreesBlocksLeftAfterBurst) {
+    Slab::Pool pool(2);
+    Slab slab(kPerBlock, pool);
+    std::vector<LOB::Order*> orders;
+    for (size_t i = 0; i < 40 * kPerBlock; ++i) orders.push_back(slab.allocate());
+    EXPECT_EQ(pool.outstandingBlocks(), 40u);
+    EXPECT_EQ(pool.cachedBlocks(), 0u);
+
+    for (LOB::Order* order : orders) slab.deallocate(order);
+    EXPECT_EQ(pool.outstandingBlocks(), 1u);
+    EXPECT_LE(pool.cachedBlocks(), 2u);
+
+    // reserve() raises the keep, so reserved blocks survive releases
+    pool.reserve(8);
+    orders.clear();
+    for (size_t i = 0; i < 3 * kPerBlock; ++i) orders.push_back(slab.allocate());
+    for (LOB::Order* order : orders) slab.deallocate(order);
+    EXPECT_EQ(pool.cachedBlocks(), 8u);
+}
+
+TEST(SlabAllocatorTest, RandomChurnKeepsObjectsDistinct) {
+    Slab::Pool pool;
+    Slab slab(0, pool);
+    std::mt19937_64 rng(1);
+    std::vector<LOB::Order*> live;
+    std::set<LOB::Order*> liveSet;
+    size_t peakBlocks = 0;
+
+    for (int step = 0; step < 200000; ++step) {
+        // Grow to ~20 blocks, then drain
+        bool grow = step < 100000 ? rng() % 3 != 0 : rng() % 3 == 0;
+        if (grow || live.empty()) {
+            LOB::Order* order = slab.allocate();
+            ASSERT_TRUE(liveSet.insert(order).second);
+            order->id = static_cast<LOB::OrderID>(step);
+            live.push_back(order);
+        } else {
+            size_t pick = rng() % live.size();
+            liveSet.erase(live[pick]);
+            slab.deallocate(live[pick]);
+            live[pick] = live.back();
+            live.pop_back();
+        }
+        peakBlocks = std::max(peakBlocks, slab.blockCount());
+    }
+    EXPECT_EQ(slab.liveObjects(), live.size());
+    EXPECT_GT(peakBlocks, 50u);
+    // Memory followed the drain (at most one partially used block per survivor, plus the spare)
+    EXPECT_LE(slab.blockCount(), std::min(peakBlocks, live.size() + 1));
+    for (LOB::Order* order : live) slab.deallocate(order);
+    EXPECT_LE(slab.blockCount(), 1u);
+}
+
+TEST(SlabAllocatorTest, SmallBookMemoryFollowsActivity) {
+    LOB::OrderBook book(256);
+    const LOB::BookMemory idle = book.memoryUsage();
+    EXPECT_LT(idle.total(), 64u * 1024);
+    auto& pool = LOB::BlockPool<16384>::shared();
+
+    for (uint64_t i = 1; i <= 20000; ++i) book.addOrder(i, 1000 + static_cast<int64_t>(i % 50), 10, LOB::Side::Buy, 0);
+    const LOB::BookMemory busy = book.memoryUsage();
+    EXPECT_GE(busy.orderSlab, 20000 * sizeof(LOB::Order));
+    EXPECT_GE(busy.orderIndex, 20000 * 16u);
+    const size_t busyBlocks = pool.outstandingBlocks();
+
+    for (uint64_t i = 1; i <= 20000; ++i) book.cancelOrder(i);
+    const LOB::BookMemory drained = book.memoryUsage();
+    EXPECT_LE(drained.orderSlab, 2 * 16384u);
+    EXPECT_EQ(drained.orderIndex, idle.orderIndex);
+    EXPECT_LT(drained.total(), busy.total() / 10);
+    EXPECT_EQ(book.getOrderCount(), 0u);
+    // The pool did not keep the burst's blocks
+    EXPECT_LE(pool.cachedBlocks(), std::max<size_t>(16, 2 * pool.outstandingBlocks()));
+    EXPECT_LT(pool.cachedBlocks(), busyBlocks - pool.outstandingBlocks());
+}
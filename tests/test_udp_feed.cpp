@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include "LOB/LatencyHistogram.h"
+
+#if defined(__linux__)
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include "LOB/OrderBook.h"
+#include "LOB/UdpFeed.h"
+#include "LobsterFixtures.h"
+
+namespace {
+
+std::vector<uint8_t> packet(uint64_t sequence, uint64_t firstMessage, const std::vector<LOB::RAWMessage>& records, uint16_t flags = 0) {
+    LOB::FeedPacketHeader header{sequence, firstMessage, LOB::feedClockNs(), static_cast<uint16_t>(records.size()), flags, 0};
+    std::vector<uint8_t> bytes(sizeof(header) + records.size() * sizeof(LOB::FeedRecord));
+    std::memcpy(bytes.data(), &header, sizeof(header));
+    for (size_t k = 0; k < records.size(); ++k) {
+        const LOB::FeedRecord record = LOB::toFeedRecord(records[k], LOB::feedClockNs());
+        std::memcpy(bytes.data() + sizeof(header) + k * sizeof(record), &record, sizeof(record));
+    }
+    return bytes;
+}
+
+}
+
+TEST(UdpFeedTest, HandlerCountsGapsAndStalePackets) {
+    LOB::UdpFeedHandler handler(LOB::UdpEndpoint{});
+    LOB::OrderBook book(1024);
+    auto messages = LOB::test::randomFlow(40, 41);
+    auto slice = [&](size_t from, size_t count) {
+        return std::vector<LOB::RAWMessage>(messages.begin() + static_cast<long>(from), messages.begin() + static_cast<long>(from + count));
+    };
+    auto deliver = [&](const std::vector<uint8_t>& bytes) { handler.onPacket(book, bytes.data(), bytes.size(), LOB::feedClockNs()); };
+
+    deliver(packet(0, 0, slice(0, 10)));
+    deliver(packet(1, 10, slice(10, 5)));
+    deliver(packet(3, 20, slice(20, 8)));  // packet 2 (messages 15-19) lost
+    deliver(packet(1, 10, slice(10, 5)));  // duplicate
+    auto truncated = packet(4, 28, slice(28, 4));
+    truncated.pop_back();
+    deliver(truncated);
+    deliver(packet(6, 40, {}, LOB::kFeedEndOfStream));  // packets 4 and 5 never arrive intact
+
+    const LOB::FeedStats& stats = handler.stats();
+    EXPECT_EQ(stats.packets, 3u);
+    EXPECT_EQ(stats.messages, 23u);
+    EXPECT_EQ(stats.gaps, 2u);
+    EXPECT_EQ(stats.missedPackets, 3u);
+    EXPECT_EQ(stats.missedMessages, 17u);
+    EXPECT_EQ(stats.stale, 1u);
+    EXPECT_EQ(stats.malformed, 1u);
+    EXPECT_TRUE(stats.endOfStream);
+    EXPECT_EQ(handler.packetLatency().count(), 3u);
+    EXPECT_EQ(handler.endToEndLatency().count(), 23u);
+}
+
+TEST(UdpFeedTest, HeartbeatsAndTimeoutCountLostPackets) {
+    LOB::UdpFeedHandler handler(LOB::UdpEndpoint{});
+    LOB::OrderBook book(1024);
+    auto messages = LOB::test::randomFlow(30, 43);
+    auto deliver = [&](const std::vector<uint8_t>& bytes) { handler.onPacket(book, bytes.data(), bytes.size(), LOB::feedClockNs()); };
+
+    deliver(packet(0, 0, {messages.begin(), messages.begin() + 10}));
+    deliver(packet(1, 10, {}, LOB::kFeedHeartbeat));  // idle, nothing missing
+    deliver(packet(3, 20, {}, LOB::kFeedHeartbeat));  // packets 1-2 (messages 10-19) lost before the quiet spell
+    deliver(packet(1, 10, {}, LOB::kFeedHeartbeat));  // late heartbeat: ignored
+    deliver(packet(3, 20, {messages.begin() + 20, messages.begin() + 25}));
+
+    const LOB::FeedStats& stats = handler.stats();
+    EXPECT_EQ(stats.heartbeats, 3u);
+    EXPECT_EQ(stats.gaps, 1u);
+    EXPECT_EQ(stats.missedPackets, 2u);
+    EXPECT_EQ(stats.missedMessages, 10u);
+    EXPECT_EQ(stats.stale, 0u);
+    EXPECT_EQ(stats.messages, 15u);
+
+    // The feed died after packet 3: the gateway went on to packet 5 and
+    // message 30, then end of stream (packet 6)
+    handler.countLostTail(7, 30);
+    EXPECT_EQ(stats.gaps, 2u);
+    EXPECT_EQ(stats.missedPackets, 5u);
+    EXPECT_EQ(stats.missedMessages, 15u);
+    EXPECT_FALSE(stats.endOfStream);
+}
+
+TEST(UdpFeedTest, QuietSpellLongerThanIdleTimeout) {
+    LOB::FeedHandlerConfig config;
+    config.idleTimeoutMs = 200;
+    LOB::UdpFeedHandler handler(LOB::UdpEndpoint{}, config);
+
+    // 400 ms of event-time silence halfway through, replayed in real time
+    auto messages = LOB::test::randomFlow(100, 47);
+    for (size_t i = 50; i < messages.size(); ++i) messages[i].timestamp += 0.4;
+    LOB::OrderBook reference(1024);
+    for (const auto& msg : messages) reference.apply(msg);
+
+    LOB::OrderBook book(1024);
+    std::exception_ptr handlerError;
+    std::thread receiver([&] {
+        try {
+            handler.run(book);
+        } catch (...) {
+            handlerError = std::current_exception();
+        }
+    });
+    LOB::GatewayStats sent;
+    try {
+        LOB::UdpEndpoint target;
+        target.port = handler.port();
+        LOB::UdpGateway gateway(target);
+        LOB::FeedPacing pacing;
+        pacing.heartbeatNs = 50000000;
+        sent = gateway.replay(messages, pacing);
+        gateway.endOfStream();
+    } catch (...) {
+        handler.stop();
+        receiver.join();
+        throw;
+    }
+    receiver.join();
+    if (handlerError) std::rethrow_exception(handlerError);
+
+    const LOB::FeedStats& stats = handler.stats();
+    EXPECT_GT(sent.heartbeats, 0u);
+    EXPECT_EQ(stats.heartbeats, sent.heartbeats);
+    EXPECT_TRUE(stats.endOfStream);
+    EXPECT_EQ(stats.missedPackets, 0u);
+    EXPECT_EQ(stats.messages, messages.size());
+    LOB::PriceLevel expected[40], actual[40];
+    const size_t n = reference.getDepth(LOB::Side::Buy, expected, 40);
+    ASSERT_EQ(book.getDepth(LOB::Side::Buy, actual, 40), n);
+    for (size_t i = 0; i < n; ++i) EXPECT_EQ(actual[i].volume, expected[i].volume);
+}
+
+TEST(UdpFeedTest, LoopbackReplayRebuildsTheBook) {
+    LOB::UdpFeedHandler handler(LOB::UdpEndpoint{});
+
+    // Send no more than the receive queue can hold with the handler stalled
+    // throughout, so a busy machine cannot drop packets. Without CAP_NET_ADMIN
+    // the queue is capped by net.core.rmem_max (212992 by default, reported
+    // doubled). Budget 4 KiB of queue per full datagram, with 2x headroom.
+    const size_t datagrams = static_cast<size_t>(handler.receiveBufferBytes()) / 4096 / 2;
+    const size_t count = std::min<size_t>(20000, datagrams * LOB::kFeedMaxRecords);
+    if (count < 1000) GTEST_SKIP() << "receive buffer too small: " << handler.receiveBufferBytes() << " bytes";
+    auto original = LOB::test::randomFlow(static_cast<int>(count), 41);
+
+    // Binary replay file round trip
+    auto path = std::filesystem::temp_directory_path() / "lob_udp_feed_day.bin";
+    LOB::writeFeedFile(path.string(), original);
+    auto messages = LOB::loadFeedMessages(path.string());
+    std::filesystem::remove(path);
+    ASSERT_EQ(messages.size(), original.size());
+    for (size_t i = 0; i < messages.size(); ++i) {
+        ASSERT_EQ(messages[i].orderId, original[i].orderId);
+        ASSERT_EQ(messages[i].price, original[i].price);
+        ASSERT_EQ(messages[i].size, original[i].size);
+        ASSERT_EQ(messages[i].type, original[i].type);
+        ASSERT_EQ(messages[i].direction, original[i].direction);
+        ASSERT_NEAR(messages[i].timestamp, original[i].timestamp, 1e-9);
+    }
+
+    LOB::OrderBook reference(4096);
+    for (const auto& msg : original) reference.apply(msg);
+
+    LOB::OrderBook book(4096);
+    std::exception_ptr handlerError;
+    std::thread receiver([&] {
+        try {
+            handler.run(book);
+        } catch (...) {
+            handlerError = std::current_exception();
+        }
+    });
+    LOB::GatewayStats sent;
+    try {
+        LOB::UdpEndpoint target;
+        target.port = handler.port();
+        LOB::UdpGateway gateway(target);
+        LOB::FeedPacing pacing;
+        pacing.rate = 500000;
+        pacing.flushNs = 1000000000; // only full packets, so the datagram budget above holds
+        sent = gateway.replay(messages, pacing);
+        gateway.endOfStream();
+    } catch (...) {
+        handler.stop();
+        receiver.join();
+        throw;
+    }
+    receiver.join();
+    if (handlerError) std::rethrow_exception(handlerError);
+
+    const LOB::FeedStats& stats = handler.stats();
+    EXPECT_EQ(sent.messages, messages.size());
+    EXPECT_TRUE(stats.endOfStream);
+    EXPECT_EQ(stats.missedPackets, 0u);
+    EXPECT_EQ(stats.packets, sent.packets);
+    EXPECT_EQ(stats.messages, messages.size());
+    EXPECT_EQ(handler.endToEndLatency().count(), messages.size());
+    EXPECT_GE(handler.endToEndLatency().percentile(0.99), handler.endToEndLatency().percentile(0.5));
+
+    for (LOB::Side side : {LOB::Side::Buy, LOB::Side::Sell}) {
+        LOB::PriceLevel expected[40], actual[40];
+        const size_t n = reference.getDepth(side, expected, 40);
+        ASSERT_EQ(book.getDepth(side, actual, 40), n);
+        for (size_t i = 0; i < n; ++i) {
+            EXPECT_EQ(actual[i].price, expected[i].price);
+            EXPECT_EQ(actual[i].volume, expected[i].volume);
+        }
+    }
+}
+
+#endif
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketPrecision) {
+    LOB::LatencyHistogram h;
+    EXPECT_EQ(h.percentile(0.5), 0u);
+    for (int64_t v = 1; v <= 100000; ++v) h.record(v);
+    h.record(-5); // clock skew: counted as 0
+
+    EXPECT_EQ(h.count(), 100001u);
+    EXPECT_EQ(h.min(), 0u);
+    EXPECT_EQ(h.max(), 100000u);
+    EXPECT_NEAR(h.mean(), 50000.0, 1.0);
+    const double relative = 1.0 / LOB::LatencyHistogram::kSubBuckets;
+    EXPECT_NEAR(static_cast<double>(h.percentile(0.5)), 50000.0, 50000.0 * relative);
+    EXPECT_NEAR(static_cast<double>(h.percentile(0.99)), 99000.0, 99000.0 * relative);
+    EXPECT_EQ(h.percentile(1.0), 100000u);
+
+    // Small values are exact
+    LOB::LatencyHistogram small;
+    for (int v = 0; v < 50; ++v) small.record(v);
+    EXPECT_EQ(small.percentile(0.5), 24u);
+
+    LOB::LatencyHistogram merged;
+    merged.merge(small);
+    merged.merge(h);
+    EXPECT_EQ(merged.count(), h.count() + small.count());
+    EXPECT_EQ(merged.max(), 100000u);
+}